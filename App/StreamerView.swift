@@ -28,6 +28,13 @@ struct StreamerView: View {
                             .font(.system(.caption2, design: .monospaced))
                             .foregroundStyle(.secondary)
                     }
+                    if !streamer.profiling.isEmpty {
+                        Text(streamer.profiling)
+                            .font(.system(.caption2, design: .monospaced))
+                            .foregroundStyle(.secondary)
+                            .lineLimit(2)
+                            .minimumScaleFactor(0.7)
+                    }
                 }
                 Spacer()
             }
@@ -57,6 +64,13 @@ struct StreamerView: View {
                 Button("Force keyframe") { streamer.requestKeyframe() }
                     .buttonStyle(.bordered)
                     .disabled(!streamer.isRunning || streamer.isBusy)
+
+                Button(streamer.isRecording ? "Stop rec" : "Rec") {
+                    streamer.setRecording(!streamer.isRecording)
+                }
+                .buttonStyle(.bordered)
+                .tint(streamer.isRecording ? .red : nil)
+                .disabled(!streamer.isRunning || streamer.isBusy)
             }
 
             Divider()
@@ -72,11 +86,62 @@ struct StreamerView: View {
                             .frame(minWidth: 60, alignment: .trailing)
                     }
                 }
+                HStack {
+                    Text("File d'envoi")
+                    Spacer()
+                    Stepper(value: $pending.sendQueueDepth, in: 1...4, step: 1) {
+                        Text("\(pending.sendQueueDepth) frame\(pending.sendQueueDepth > 1 ? "s" : "")")
+                            .frame(minWidth: 60, alignment: .trailing)
+                    }
+                }
+                Toggle("Horodatage latence (SEI)", isOn: $pending.latencyTags)
+                Toggle("Transport faible latence", isOn: $pending.lowLatencyTransport)
+                Toggle("Démarrer à la connexion d'un lecteur", isOn: $pending.startOnConnect)
+                if pending.lowLatencyTransport {
+                    Text(pending.outputProtocol.usesUDP
+                         ? "interactiveVideo (ECN off : pas de retour CE) ; file d'envoi sans marge"
+                         : "TCP nodelay + interactiveVideo ; file d'envoi sans marge (~\(pending.sendQueueDepth) frames)")
+                        .font(.caption)
+                        .foregroundStyle(.secondary)
+                }
+                Picker("Lien", selection: $pending.link) {
+                    ForEach(LinkMode.allCases, id: \.self) { l in
+                        Text(l.label).tag(l)
+                    }
+                }
+                .pickerStyle(.segmented)
+                if pending.link == .wired {
+                    Text(pending.outputProtocol.usesUDP
+                         ? "Filaire : Ethernet USB uniquement (usbmuxd ne transporte pas l'UDP)"
+                         : "Filaire : tunnel USB (iproxy) ou Ethernet USB ; Wi-Fi et cellulaire refusés")
+                        .font(.caption)
+                        .foregroundStyle(.secondary)
+                }
                 Picker("Protocol", selection: $pending.outputProtocol) {
                     Text("H.264 Annex-B (recommandé)").tag(OutputProtocol.annexb)
                     Text("H.264 AVCC (expérimental)").tag(OutputProtocol.avcc)
+                    Text("Framed (en-tête WCSF)").tag(OutputProtocol.framed)
+                    Text("RTP/UDP").tag(OutputProtocol.rtp)
                 }
                 .pickerStyle(.segmented)
+
+                if pending.outputProtocol.usesUDP {
+                    Picker("FEC", selection: $pending.fecGroupSize) {
+                        Text("FEC off").tag(0)
+                        Text("1/4").tag(4)
+                        Text("1/8").tag(8)
+                        Text("1/16").tag(16)
+                    }
+                    .pickerStyle(.segmented)
+                    HStack {
+                        Text("NACK deadline")
+                        Spacer()
+                        Stepper(value: $pending.nackDeadlineMs, in: 0...100, step: 4) {
+                            Text(pending.nackDeadlineMs > 0 ? "\(Int(pending.nackDeadlineMs)) ms" : "off")
+                                .frame(minWidth: 60, alignment: .trailing)
+                        }
+                    }
+                }
             }
 
             Divider()
@@ -110,7 +175,41 @@ struct StreamerView: View {
                            step: 1_000_000)
                 }
 
-                Toggle("All-I (GOP=1, latence minimale)", isOn: $pending.intraOnly)
+                Toggle("Débit adaptatif (bitrate = plafond)", isOn: $pending.adaptiveBitrate)
+
+                if pending.adaptiveBitrate && pending.outputProtocol.usesUDP {
+                    Text("RTP : pas de signal de congestion côté envoi, débit fixe")
+                        .font(.caption)
+                        .foregroundStyle(.secondary)
+                } else if pending.adaptiveBitrate {
+                    HStack {
+                        Text("Plancher: \(Int(pending.minBitrate/1_000_000)) Mb/s")
+                        Slider(value: $pending.minBitrate,
+                               in: 2_000_000...max(2_000_000, pending.bitrate),
+                               step: 1_000_000)
+                    }
+                }
+
+                Picker("GOP", selection: $pending.gopMode) {
+                    ForEach(GOPMode.allCases, id: \.self) { g in
+                        Text(g.label).tag(g)
+                    }
+                }
+                .pickerStyle(.segmented)
+
+                if pending.gopMode == .refresh {
+                    HStack {
+                        Text("IDR de sécurité")
+                        Spacer()
+                        Stepper(value: $pending.refreshInterval, in: 0...10, step: 1) {
+                            Text(pending.refreshInterval > 0 ? "\(Int(pending.refreshInterval)) s" : "jamais")
+                                .frame(minWidth: 60, alignment: .trailing)
+                        }
+                    }
+                    Text("Frames plafonnées à ~2x la moyenne : débit plat, IDR sur demande du lecteur")
+                        .font(.caption)
+                        .foregroundStyle(.secondary)
+                }
 
                 Picker("Orientation", selection: $pending.orientation) {
                     Text("Portrait").tag(AVCaptureVideoOrientation.portrait)
@@ -124,9 +223,16 @@ struct StreamerView: View {
 
             Divider()
 
-            // H.264
+            // Codec
             Group {
-                Text("H.264").font(.headline)
+                Text("Codec").font(.headline)
+
+                Picker("Codec", selection: $pending.codec) {
+                    ForEach(VideoCodec.allCases, id: \.self) { c in
+                        Text(c.label).tag(c)
+                    }
+                }
+                .pickerStyle(.segmented)
 
                 Picker("Profile", selection: $pending.profile) {
                     ForEach(H264Profile.allCases, id: \.self) { p in
@@ -134,6 +240,7 @@ struct StreamerView: View {
                     }
                 }
                 .pickerStyle(.segmented)
+                .disabled(pending.codec.isHEVC)
 
                 Picker("Entropy", selection: $pending.entropy) {
                     ForEach(H264Entropy.allCases, id: \.self) { e in
@@ -141,18 +248,58 @@ struct StreamerView: View {
                     }
                 }
                 .pickerStyle(.segmented)
-                .disabled(pending.profile == .baseline)
+                .disabled(pending.profile == .baseline || pending.codec.isHEVC)
 
-                if pending.profile == .baseline {
+                if pending.codec.isHEVC {
+                    Text("HEVC : profil \(pending.codec == .hevc10 ? "Main10" : "Main"), CABAC imposé")
+                        .font(.caption)
+                        .foregroundStyle(.secondary)
+                } else if pending.profile == .baseline {
                     Text("Baseline impose CAVLC (CABAC indisponible)")
                         .font(.caption)
                         .foregroundStyle(.secondary)
                 }
+
+                Toggle("Low-latency (RC faible latence + slices)", isOn: $pending.lowLatency)
+
+                if pending.lowLatency {
+                    HStack {
+                        Text("Slices / frame")
+                        Spacer()
+                        Stepper(value: $pending.slicesPerFrame, in: 1...8, step: 1) {
+                            Text("\(pending.slicesPerFrame)")
+                                .frame(minWidth: 60, alignment: .trailing)
+                        }
+                    }
+                    if pending.outputProtocol.usesUDP {
+                        Text("RTP : slices alignées sur la taille de paquet")
+                            .font(.caption)
+                            .foregroundStyle(.secondary)
+                    }
+                }
+
+                Toggle("Pré-chauffer l'encodeur", isOn: $pending.prewarmEncoder)
+
+                Toggle("Gouverneur thermique", isOn: $pending.thermalGovernor)
+
+                if pending.thermalGovernor {
+                    Text("Chauffe ou encodeur saturé : fps ≤ 60, puis débit -30 %, résolution -1 cran, fps ≤ 30 ; remontée après ~30 s au frais")
+                        .font(.caption)
+                        .foregroundStyle(.secondary)
+                }
+
+                if pending.prewarmEncoder {
+                    Text("2e session prête pour le mode précédent (ou 720p ↔ 4K) : bascule sans démarrage à froid, au prix d'un peu de mémoire")
+                        .font(.caption)
+                        .foregroundStyle(.secondary)
+                }
             }
 
             Divider()
 
-            Text("Astuce : après Apply, lance `iproxy \(pending.port) \(pending.port)` puis `ffplay -fflags nobuffer -flags low_delay -probesize 2048 -analyzeduration 0 -vsync drop -use_wallclock_as_timestamps 1 -i tcp://127.0.0.1:\(pending.port)?tcp_nodelay=1`.")
+            Text(pending.outputProtocol.usesUDP
+                 ? "Astuce : RTP/UDP (\(pending.codec.isHEVC ? "RFC 7798" : "RFC 6184"), PT 96, 90 kHz). Le lecteur s'abonne en envoyant un datagramme vers le port \(pending.port) de l'iPhone."
+                 : "Astuce : après Apply, lance `iproxy \(pending.port) \(pending.port)` puis `ffplay -fflags nobuffer -flags low_delay -probesize 2048 -analyzeduration 0 -vsync drop -use_wallclock_as_timestamps 1 -i tcp://127.0.0.1:\(pending.port)?tcp_nodelay=1`.")
                 .font(.footnote)
                 .foregroundStyle(.secondary)
                 .lineLimit(3)
@@ -47,7 +47,10 @@ struct WinCamStreamIOSApp: App {
                     }
                 }
             }
-            .onAppear { pending = PendingConfig(from: streamer) }
+            .onAppear {
+                pending = PendingConfig(from: streamer)
+                streamer.advertise() // annonce Bonjour avant le Start
+            }
         }
     }
 }
@@ -0,0 +1,174 @@
+import XCTest
+import CoreMedia
+@testable import WinCamStreamIOS
+
+/// Débit du packer (AVCC → Annex-B / framed / RTP + FEC) sur un flux rejoué, sans caméra.
+/// Entrée : le fichier .wcsf pointé par `WCSF_PATH` (schéma > Test > Arguments), sinon un
+/// .wcsf embarqué dans le bundle de test, sinon un flux synthétique 4K all-I déterministe.
+/// Les access units sont converties une fois en CMBlockBuffer AVCC, comme en sortie VT.
+final class PackerBenchmarks: XCTestCase {
+    private struct Frame {
+        let block: CMBlockBuffer
+        let isKey: Bool
+        let ptsNs: UInt64
+    }
+
+    private static var frames: [Frame] = []
+    private static var source = ""
+    private static var hevc = false // codec du .wcsf (octet 5 de l'en-tête)
+
+    override class func setUp() {
+        super.setUp()
+        let env = ProcessInfo.processInfo.environment["WCSF_PATH"].map { URL(fileURLWithPath: $0) }
+        let bundled = Bundle(for: PackerBenchmarks.self).urls(forResourcesWithExtension: "wcsf", subdirectory: nil)?.first
+        if let url = env ?? bundled, let data = try? Data(contentsOf: url) {
+            frames = parseCapture(data)
+            source = url.lastPathComponent
+        }
+        if frames.isEmpty {
+            hevc = false
+            frames = synthetic(count: 120, frameBytes: 600_000, slices: 4)
+            source = "synthétique 4K all-I"
+        }
+    }
+
+    // MARK: Benchmarks
+
+    func testAnnexBPacking() {
+        measureFrames { f in
+            guard let d = NALPacker.annexBFromSampleBuffer(dataBuffer: f.block) else { return 0 }
+            return NALPacker.contiguousRegions(d).reduce(0) { $0 + $1.count }
+        }
+    }
+
+    func testFramedPacking() {
+        measureFrames { f in
+            guard let body = NALPacker.annexBFromSampleBuffer(dataBuffer: f.block) else { return 0 }
+            var out = FrameHeader.make(hevc: PackerBenchmarks.hevc, flags: f.isKey ? [.keyframe] : [], seq: 0,
+                                       ptsNs: f.ptsNs, length: body.count)
+            out.append(body)
+            return NALPacker.contiguousRegions(out).reduce(0) { $0 + $1.count }
+        }
+    }
+
+    func testRTPPacketization() {
+        let rtp = RTPPacketizer(hevc: PackerBenchmarks.hevc)
+        measureFrames { f in
+            let pts = CMTime(value: CMTimeValue(f.ptsNs), timescale: 1_000_000_000)
+            return rtp.packetize(dataBuffer: f.block, prefixNALs: [], pts: pts).reduce(0) { $0 + $1.count }
+        }
+    }
+
+    func testRTPWithFEC() {
+        let rtp = RTPPacketizer(hevc: PackerBenchmarks.hevc)
+        let fec = RTPFECEncoder(mediaSSRC: rtp.ssrc)
+        measureFrames { f in
+            let pts = CMTime(value: CMTimeValue(f.ptsNs), timescale: 1_000_000_000)
+            let first = rtp.nextSequenceNumber
+            let media = rtp.packetize(dataBuffer: f.block, prefixNALs: [], pts: pts)
+            return fec.protect(media, firstSeq: first, timestamp: RTPPacketizer.timestamp(for: pts), groupSize: 10)
+                .reduce(0) { $0 + $1.count }
+        }
+    }
+
+    /// Un passage = toutes les frames ; les métriques XCTest sont ramenées à la frame dans le log
+    private func measureFrames(_ pack: @escaping (Frame) -> Int) {
+        let frames = PackerBenchmarks.frames
+        let bytes = frames.reduce(0) { $0 + CMBlockBufferGetDataLength($1.block) }
+        print("[bench] \(name): \(frames.count) frames, \(bytes / max(1, frames.count)) o/frame (\(PackerBenchmarks.source))")
+        let options = XCTMeasureOptions()
+        options.iterationCount = 10
+        measure(metrics: [XCTClockMetric(), XCTCPUMetric(), XCTMemoryMetric()], options: options) {
+            var out = 0
+            for f in frames { out &+= pack(f) }
+            XCTAssertGreaterThan(out, 0)
+        }
+    }
+
+    // MARK: Entrée
+
+    /// Enregistrements .wcsf (cf. FramedProtocol) → access units AVCC ; préludes hors séquence ignorés
+    private static func parseCapture(_ data: Data) -> [Frame] {
+        let b = [UInt8](data)
+        var out: [Frame] = []
+        var off = 0
+        while off + FrameHeader.size <= b.count {
+            guard Array(b[off..<off + 4]) == FrameHeader.magic else { break }
+            hevc = b[off + 5] == 1
+            let flags = FrameHeader.Flags(rawValue: b[off + 6])
+            let hdr = Int(b[off + 7])
+            let pts = (0..<8).reduce(UInt64(0)) { $0 << 8 | UInt64(b[off + 12 + $1]) }
+            let len = Int((0..<4).reduce(UInt32(0)) { $0 << 8 | UInt32(b[off + 20 + $1]) })
+            let start = off + hdr
+            guard start + len <= b.count else { break }
+            if !flags.contains(.outOfSequence), let block = avcc(fromAnnexB: b[start..<start + len]) {
+                out.append(Frame(block: block, isKey: flags.contains(.keyframe), ptsNs: pts))
+            }
+            off = start + len
+        }
+        return out
+    }
+
+    /// Annex-B (start codes 3 ou 4 octets) → longueurs 4 octets big-endian
+    private static func avcc(fromAnnexB au: ArraySlice<UInt8>) -> CMBlockBuffer? {
+        var nals: [Range<Int>] = []
+        var i = au.startIndex
+        var nalStart: Int?
+        while i + 2 < au.endIndex {
+            if au[i] == 0 && au[i + 1] == 0 && au[i + 2] == 1 {
+                if let s = nalStart {
+                    var e = i
+                    if e > s && au[e - 1] == 0 { e -= 1 } // start code 4 octets
+                    nals.append(s..<e)
+                }
+                i += 3
+                nalStart = i
+            } else {
+                i += 1
+            }
+        }
+        if let s = nalStart, s < au.endIndex { nals.append(s..<au.endIndex) }
+        var bytes: [UInt8] = []
+        bytes.reserveCapacity(au.count + 4 * nals.count)
+        for r in nals {
+            let n = UInt32(r.count)
+            bytes += [UInt8(n >> 24), UInt8(truncatingIfNeeded: n >> 16), UInt8(truncatingIfNeeded: n >> 8), UInt8(truncatingIfNeeded: n)]
+            bytes += au[r]
+        }
+        return block(bytes)
+    }
+
+    /// Flux déterministe : IDR de `slices` NAL de taille égale, contenu pseudo-aléatoire
+    private static func synthetic(count: Int, frameBytes: Int, slices: Int) -> [Frame] {
+        var state: UInt32 = 0x12345678
+        return (0..<count).compactMap { i in
+            var bytes: [UInt8] = []
+            bytes.reserveCapacity(frameBytes + 4 * slices)
+            let per = frameBytes / slices
+            for _ in 0..<slices {
+                let n = UInt32(per)
+                bytes += [UInt8(n >> 24), UInt8(truncatingIfNeeded: n >> 16), UInt8(truncatingIfNeeded: n >> 8), UInt8(truncatingIfNeeded: n)]
+                bytes.append(0x65) // slice IDR H.264
+                for _ in 1..<per {
+                    state = state &* 1_664_525 &+ 1_013_904_223
+                    bytes.append(UInt8(truncatingIfNeeded: state >> 24))
+                }
+            }
+            return block(bytes).map { Frame(block: $0, isKey: true, ptsNs: UInt64(i) * 8_333_333) }
+        }
+    }
+
+    private static func block(_ bytes: [UInt8]) -> CMBlockBuffer? {
+        var bb: CMBlockBuffer?
+        guard CMBlockBufferCreateWithMemoryBlock(allocator: kCFAllocatorDefault, memoryBlock: nil,
+                                                 blockLength: bytes.count, blockAllocator: kCFAllocatorDefault,
+                                                 customBlockSource: nil, offsetToData: 0, dataLength: bytes.count,
+                                                 flags: kCMBlockBufferAssureMemoryNowFlag, blockBufferOut: &bb) == noErr,
+              let b = bb else { return nil }
+        let ok = bytes.withUnsafeBytes { p in
+            CMBlockBufferReplaceDataBytes(with: p.baseAddress!, blockBuffer: b, offsetIntoDestination: 0,
+                                          dataLength: bytes.count) == noErr
+        }
+        return ok ? b : nil
+    }
+}
@@ -0,0 +1,107 @@
+import Foundation
+
+/// Régulation de débit en boucle fermée (AIMD) à partir de la vidange de la file d'envoi.
+/// Par fenêtre de stats : latence de complétion des envois + frames jetées. Congestion →
+/// baisse multiplicative ; lien dégagé plusieurs fenêtres d'affilée → hausse additive.
+/// Après chaque changement on attend quelques fenêtres (hystérésis) avant de rebouger.
+/// TCP seulement : en UDP `.contentProcessed` ne mesure que la copie locale, sans signal de congestion.
+final class BitrateController {
+    struct Window {
+        var frames = 0
+        var drops = 0
+        var avgLatency: Double = 0 // s
+        var maxLatency: Double = 0 // s
+    }
+
+    private(set) var floor: Int
+    private(set) var ceiling: Int
+    private var value: Int
+
+    /// Débit encodeur courant (lu par sessionQ / stats pendant que record/evaluate tournent)
+    var current: Int {
+        lock.lock(); defer { lock.unlock() }
+        return value
+    }
+
+    private let decrease = 0.80        // x0.8 sur congestion
+    private let increaseStep = 0.05    // +5 % du plafond sur lien dégagé
+    private let clearWindowsToRaise = 3
+    private let holdWindowsAfterChange = 2
+
+    private let lock = NSLock() // record (queue réseau) / evaluate (stats)
+    private var latSum: Double = 0
+    private var latMax: Double = 0
+    private var latCount = 0
+    private var clearStreak = 0
+    private var hold = 0
+
+    init(floor: Int, ceiling: Int) {
+        self.floor = min(floor, ceiling)
+        self.ceiling = ceiling
+        self.value = ceiling
+    }
+
+    /// Nouvelle session : repart du plafond
+    func reset(floor: Int, ceiling: Int) {
+        lock.lock(); defer { lock.unlock() }
+        self.floor = min(floor, ceiling)
+        self.ceiling = ceiling
+        value = ceiling
+        latSum = 0; latMax = 0; latCount = 0
+        clearStreak = 0; hold = 0
+    }
+
+    /// Bornes changées en cours de session (UI, gouverneur, setBitrate) : le débit atteint
+    /// est conservé, seulement ramené dans [floor, ceiling]. Sans effet si rien ne change.
+    func setRange(floor: Int, ceiling: Int) {
+        lock.lock(); defer { lock.unlock() }
+        let f = min(floor, ceiling)
+        guard f != self.floor || ceiling != self.ceiling else { return }
+        self.floor = f
+        self.ceiling = ceiling
+        value = min(max(value, f), ceiling)
+    }
+
+    /// Latence envoi → .contentProcessed d'une frame
+    func record(sendLatency: Double) {
+        lock.lock(); defer { lock.unlock() }
+        latSum += sendLatency
+        latMax = max(latMax, sendLatency)
+        latCount += 1
+    }
+
+    /// Fin de fenêtre : renvoie le nouveau débit s'il change.
+    func evaluate(drops: Int, frameInterval: Double) -> Int? {
+        lock.lock(); defer { lock.unlock() }
+        let w = Window(frames: latCount, drops: drops,
+                       avgLatency: latCount > 0 ? latSum / Double(latCount) : 0,
+                       maxLatency: latMax)
+        latSum = 0; latMax = 0; latCount = 0
+
+        if hold > 0 { hold -= 1; return nil }
+
+        // Congestion : frames jetées, ou l'envoi met plus de 2 frames à se vider
+        let congested = w.drops > 0 || w.avgLatency > 2 * frameInterval
+        // Dégagé : rien de jeté et vidange en moins d'une demi-frame
+        let clear = w.drops == 0 && w.frames > 0 && w.maxLatency < frameInterval / 2
+
+        var next = value
+        if congested {
+            clearStreak = 0
+            next = max(floor, Int(Double(value) * decrease))
+        } else if clear {
+            clearStreak += 1
+            if clearStreak >= clearWindowsToRaise {
+                clearStreak = 0
+                next = min(ceiling, value + Int(Double(ceiling) * increaseStep))
+            }
+        } else {
+            clearStreak = 0
+        }
+
+        guard next != value else { return nil }
+        value = next
+        hold = holdWindowsAfterChange
+        return next
+    }
+}
@@ -0,0 +1,92 @@
+import Foundation
+import Network
+
+/// Messages lecteur → iPhone, sur la connexion du flux (TCP) ou en datagrammes (UDP).
+/// Trame : 'W' 'C' | type (u8) | longueur payload (u8) | payload (big-endian).
+/// Un datagramme RTP/RTCP commence par V=2 (0b10…), jamais par 'W' : pas d'ambiguïté.
+///   0x01 clockPing       t0 u64
+///   0x02 requestIDR      —
+///   0x03 invalidateRefs  première seq perdue u32
+///   0x04 setBitrate      bit/s u32
+///   0x05 setFPS          fps u16
+///   0x06 latencyReport   p50/p95/p99 u16 chacun (1/10 ms, bout en bout côté lecteur)
+///   0x07 keepalive       —  (UDP : au moins toutes les secondes, sinon le lecteur est
+///                            retiré après 5 s de silence ; tout datagramme compte)
+enum ControlMessage {
+    case clockPing(t0: UInt64)       // horloge lecteur (ns), renvoyée dans le SEI de latence
+    case requestIDR                  // erreur de décodage : resynchro immédiate
+    case invalidateRefs(fromSeq: UInt32)
+    case setBitrate(Int)
+    case setFPS(Double)
+    case latencyReport(p50: Double, p95: Double, p99: Double) // ms
+    case keepalive                   // lecteur UDP toujours là
+
+    static let magic: [UInt8] = [0x57, 0x43]
+    static let headerSize = 4
+
+    static func isControl(_ d: Data) -> Bool {
+        d.count >= headerSize && d[d.startIndex] == magic[0] && d[d.startIndex + 1] == magic[1]
+    }
+
+    /// Décode un message complet (en-tête + payload). Types inconnus ignorés.
+    static func parse(_ d: Data) -> ControlMessage? {
+        guard isControl(d) else { return nil }
+        let b = [UInt8](d)
+        let type = b[2]
+        let len = Int(b[3])
+        guard b.count >= headerSize + len else { return nil }
+        let p = Array(b[headerSize..<headerSize + len])
+        switch type {
+        case 0x01 where len >= 8:
+            return .clockPing(t0: be64(p, 0))
+        case 0x02:
+            return .requestIDR
+        case 0x03 where len >= 4:
+            return .invalidateRefs(fromSeq: be32(p, 0))
+        case 0x04 where len >= 4:
+            return .setBitrate(Int(be32(p, 0)))
+        case 0x05 where len >= 2:
+            return .setFPS(Double(be16(p, 0)))
+        case 0x06 where len >= 6:
+            return .latencyReport(p50: Double(be16(p, 0)) / 10,
+                                  p95: Double(be16(p, 2)) / 10,
+                                  p99: Double(be16(p, 4)) / 10)
+        case 0x07:
+            return .keepalive
+        default:
+            return nil
+        }
+    }
+
+    static func be16(_ b: [UInt8], _ o: Int) -> UInt16 { UInt16(b[o]) << 8 | UInt16(b[o + 1]) }
+    static func be32(_ b: [UInt8], _ o: Int) -> UInt32 {
+        (0..<4).reduce(UInt32(0)) { $0 << 8 | UInt32(b[o + $1]) }
+    }
+
+    static func be64(_ b: [UInt8], _ o: Int) -> UInt64 {
+        (0..<8).reduce(UInt64(0)) { $0 << 8 | UInt64(b[o + $1]) }
+    }
+}
+
+enum ControlChannel {
+    /// Lecture continue des messages sur un flux TCP (en-tête puis payload)
+    static func receiveStream(on conn: NWConnection, _ handler: @escaping (ControlMessage) -> Void) {
+        conn.receive(minimumIncompleteLength: ControlMessage.headerSize,
+                     maximumLength: ControlMessage.headerSize) { [weak conn] head, _, done, error in
+            guard let conn = conn, error == nil, !done,
+                  let head = head, head.count == ControlMessage.headerSize,
+                  ControlMessage.isControl(head) else { return } // flux désynchronisé : on arrête d'écouter
+            let len = Int(head[head.startIndex + 3])
+            guard len > 0 else {
+                if let m = ControlMessage.parse(head) { handler(m) }
+                receiveStream(on: conn, handler)
+                return
+            }
+            conn.receive(minimumIncompleteLength: len, maximumLength: len) { body, _, done, error in
+                guard error == nil, let body = body else { return }
+                if let m = ControlMessage.parse(head + body) { handler(m) }
+                if !done { receiveStream(on: conn, handler) }
+            }
+        }
+    }
+}
@@ -0,0 +1,114 @@
+import Foundation
+import Network
+
+/// Frame encodée une seule fois et partagée par tous les lecteurs.
+/// Les paquets référencent le CMBlockBuffer sans copie : ARC fait office de compteur
+/// de références, la frame vit tant qu'un envoi la retient.
+final class EncodedFrame {
+    let frameId: UInt64   // id FrameProfiler
+    let seq: UInt32       // numéro de frame du flux
+    let isKey: Bool
+    let bitstream: Int    // octets du bitstream (admission dans les files)
+    let packets: [DispatchData]
+    let size: Int         // octets sur le fil
+
+    fileprivate var admitted = 0 // protégés par le verrou de FrameFanOut
+    fileprivate var inFlight = 0
+
+    init(frameId: UInt64, seq: UInt32, isKey: Bool, bitstream: Int, packets: [DispatchData]) {
+        self.frameId = frameId
+        self.seq = seq
+        self.isKey = isKey
+        self.bitstream = bitstream
+        self.packets = packets
+        self.size = packets.reduce(0) { $0 + $1.count }
+    }
+}
+
+/// Distribution d'une frame aux lecteurs. Pas de ring ni de curseur : chaque frame est
+/// proposée à tous les lecteurs dès la sortie de l'encodeur (thread VT) et un lecteur
+/// saturé la jette selon sa SendQueue, rien n'attend derrière lui. Ne reste que le
+/// comptage partagé admissions / envois en cours (profiler : fin d'envoi = dernier lecteur).
+final class FrameFanOut {
+    private let lock = NSLock() // thread VT (admission) / queues réseau (complétions)
+
+    /// Propose `f` à chaque lecteur ; renvoie true si l'un d'eux a besoin d'un IDR
+    func distribute(_ f: EncodedFrame, to readers: [StreamClient], send: (StreamClient, EncodedFrame) -> Void) -> Bool {
+        var needsIDR = false
+        for c in readers {
+            switch c.queue.admit(bytes: f.bitstream, isKey: f.isKey) {
+            case .send:
+                admitted(f)
+                send(c, f)
+            case .drop:
+                break
+            case .dropNeedsIDR:
+                needsIDR = true
+            }
+        }
+        return needsIDR
+    }
+
+    private func admitted(_ f: EncodedFrame) {
+        lock.lock(); defer { lock.unlock() }
+        f.admitted += 1
+        f.inFlight += 1
+    }
+
+    /// Aucun lecteur n'a pris la frame
+    func wasDropped(_ f: EncodedFrame) -> Bool {
+        lock.lock(); defer { lock.unlock() }
+        return f.admitted == 0
+    }
+
+    /// Fin d'envoi chez un lecteur (même parti entre-temps) ; true quand le dernier a terminé
+    func completed(_ f: EncodedFrame) -> Bool {
+        lock.lock(); defer { lock.unlock() }
+        f.inFlight -= 1
+        return f.inFlight == 0
+    }
+}
+
+/// Un lecteur connecté : file d'envoi et politique de drop propres.
+/// Un lecteur lent ne retient que ses propres frames, jamais l'encodeur ni les autres.
+final class StreamClient {
+    let id: Int
+    let connection: NWConnection
+    let context: NWConnection.ContentContext // marquage des datagrammes, fixé par le listener d'origine
+    let udp: Bool
+    let queue: SendQueue
+
+    // Lecteur UDP : aucune fin de connexion n'est signalée, seul son retour prouve qu'il est là
+    private let heardLock = NSLock() // queue réseau (réception) / stats (main) / listener
+    private var heard: UInt64
+
+    init(id: Int, connection: NWConnection, context: NWConnection.ContentContext, udp: Bool,
+         depth: Int, byteBudget: Int) {
+        self.id = id
+        self.connection = connection
+        self.context = context
+        self.udp = udp
+        self.heard = HostClock.now()
+        self.queue = SendQueue(depth: depth, byteBudget: byteBudget)
+        queue.awaitKeyframe()
+    }
+
+    /// Datagramme reçu du lecteur (abonnement, NACK, contrôle, keepalive)
+    func markHeard(at ns: UInt64) {
+        heardLock.lock(); defer { heardLock.unlock() }
+        heard = max(heard, ns)
+    }
+
+    /// Temps écoulé depuis le dernier datagramme reçu (ns)
+    func silence(at now: UInt64) -> UInt64 {
+        heardLock.lock(); defer { heardLock.unlock() }
+        return now > heard ? now - heard : 0
+    }
+
+    /// Lecteur connecté avant le start (ou resté connecté après un stop) : file vidée
+    /// (les complétions de l'ancienne session sont ignorées), attente d'IDR
+    func rejoin() {
+        queue.reset()
+        queue.awaitKeyframe()
+    }
+}
@@ -0,0 +1,101 @@
+import Foundation
+import AVFoundation
+
+/// Choix du format caméra par score (latence / consommation) plutôt que le premier
+/// format aux bonnes dimensions. Le scan de `device.formats` est mis en cache par
+/// appareil + résolution : un restart ne rescanne pas.
+final class FormatSelector {
+    /// Caractéristiques relevées une fois par format
+    struct Scanned {
+        let format: AVCaptureDevice.Format
+        let maxFPS: Double
+        let subtype: FourCharCode
+        let binned: Bool
+        let hdr: Bool
+        let multiCam: Bool
+        let photoHQ: Bool // pipeline photo pleine qualité : plus gourmand
+
+        var tenBit: Bool {
+            subtype == kCVPixelFormatType_420YpCbCr10BiPlanarVideoRange
+                || subtype == kCVPixelFormatType_420YpCbCr10BiPlanarFullRange
+        }
+
+        var fullRange: Bool {
+            subtype == kCVPixelFormatType_420YpCbCr8BiPlanarFullRange
+                || subtype == kCVPixelFormatType_420YpCbCr10BiPlanarFullRange
+        }
+    }
+
+    struct Choice {
+        let scanned: Scanned
+        let score: Int
+
+        /// Ex. « 420f binned 240 fps »
+        var summary: String {
+            let s = scanned
+            var parts = [FormatSelector.fourCC(s.subtype)]
+            if s.binned { parts.append("binned") }
+            if s.hdr { parts.append("HDR off") }
+            parts.append("\(Int(s.maxFPS)) fps max")
+            return parts.joined(separator: " ")
+        }
+    }
+
+    /// Ex. « 420f » pour kCVPixelFormatType_420YpCbCr8BiPlanarFullRange
+    static func fourCC(_ v: FourCharCode) -> String {
+        String(bytes: [24, 16, 8, 0].map { UInt8(truncatingIfNeeded: v >> $0) }, encoding: .ascii) ?? "\(v)"
+    }
+
+    private let lock = NSLock() // UI (maxFPS) / sessionQ (choix)
+    private var cache: [String: [Scanned]] = [:]
+
+    func scan(_ device: AVCaptureDevice, width: Int, height: Int) -> [Scanned] {
+        let key = "\(device.uniqueID) \(width)x\(height)"
+        lock.lock(); defer { lock.unlock() }
+        if let hit = cache[key] { return hit }
+        var out: [Scanned] = []
+        for f in device.formats {
+            let dims = CMVideoFormatDescriptionGetDimensions(f.formatDescription)
+            guard dims.width == width && dims.height == height else { continue }
+            let maxF = f.videoSupportedFrameRateRanges.map { $0.maxFrameRate }.max() ?? 0
+            out.append(Scanned(format: f, maxFPS: maxF,
+                               subtype: CMFormatDescriptionGetMediaSubType(f.formatDescription),
+                               binned: f.isVideoBinned,
+                               hdr: f.isVideoHDRSupported,
+                               multiCam: f.isMultiCamSupported,
+                               photoHQ: f.isHighestPhotoQualitySupported))
+        }
+        cache[key] = out
+        return out
+    }
+
+    func maxFPS(_ device: AVCaptureDevice, width: Int, height: Int) -> Double {
+        scan(device, width: width, height: height).map { $0.maxFPS }.max() ?? 0
+    }
+
+    /// Meilleur format tenant `fps` ; nil si aucun
+    func best(_ device: AVCaptureDevice, width: Int, height: Int, fps: Double, tenBit: Bool) -> Choice? {
+        scan(device, width: width, height: height)
+            .filter { $0.maxFPS + 0.001 >= fps }
+            .map { Choice(scanned: $0, score: score($0, fps: fps, tenBit: tenBit)) }
+            .max { $0.score < $1.score }
+    }
+
+    private func score(_ s: Scanned, fps: Double, tenBit: Bool) -> Int {
+        var score = 0
+        // Profondeur demandée par le codec : évite une conversion avant l'encodeur
+        if s.tenBit == tenBit { score += 40 }
+        // Binning : lecture capteur plus courte et moins d'énergie, décisif à haute cadence
+        if s.binned { score += fps > 60 ? 30 : 10 }
+        // Le HDR vidéo fusionne des expositions : latence et consommation en plus
+        if s.hdr { score -= 10 }
+        if s.photoHQ { score -= 10 }
+        // Formats multi-cam : calibrés pour une bande passante capteur réduite
+        if s.multiCam { score += 5 }
+        // Plage pleine : pas de compression de la dynamique (comportement historique)
+        if s.fullRange { score += 3 }
+        // Le plus proche de la cadence visée (un format 240 fps pour du 30 fps est du gâchis)
+        score -= Int((s.maxFPS - fps) / 30)
+        return score
+    }
+}
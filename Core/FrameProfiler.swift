@@ -0,0 +1,177 @@
+import Foundation
+
+/// Ring lock-free d'enregistrements par frame (capture → encode → envoi).
+/// Le slot d'une frame est fixé à la capture (id % capacity) ; chaque étage écrit
+/// ses propres champs dans l'ordre causal du pipeline, puis l'étage final publie
+/// le slot en écrivant `id + 1` (release). Le lecteur (stats, 1 Hz) relit l'id
+/// avant/après la copie pour ignorer un slot réécrit entre-temps (seqlock).
+/// Aucun verrou ni allocation côté écriture.
+final class FrameProfiler {
+    enum DropReason: UInt64, CaseIterable {
+        case none = 0, busy, late, encoderError, noClient
+        var label: String {
+            switch self {
+            case .none: return "-"
+            case .busy: return "busy"
+            case .late: return "late"
+            case .encoderError: return "enc"
+            case .noClient: return "noclient"
+            }
+        }
+    }
+
+    struct Record {
+        var id: UInt64
+        var captureNs: UInt64
+        var submitStartNs: UInt64
+        var submitEndNs: UInt64
+        var encodeDoneNs: UInt64
+        var sendDoneNs: UInt64
+        var bytes: Int
+        var isKey: Bool
+        var drop: DropReason
+
+        var submitDuration: Double { ms(submitEndNs, submitStartNs) }
+        var encodeLatency: Double { ms(encodeDoneNs, captureNs) }     // capture → sortie VT
+        var encodeTime: Double { ms(encodeDoneNs, submitStartNs) }    // soumission → sortie VT (encodeur seul)
+        var sendLatency: Double { ms(sendDoneNs, encodeDoneNs) }      // sortie VT → .contentProcessed
+        private func ms(_ a: UInt64, _ b: UInt64) -> Double { a > b ? Double(a - b) / 1_000_000 : 0 }
+    }
+
+    static let capacity = 512 // ~4 s à 120 fps
+
+    // Disposition d'un slot (UInt64)
+    private enum F: Int { case commit = 0, capture, submitStart, submitEnd, encodeDone, sendDone, bytes, flags }
+    private static let words = 8
+
+    private let slots: UnsafeMutablePointer<UInt64>
+    private let drops: UnsafeMutablePointer<UInt64> // compteurs cumulés par DropReason
+    private var nextId: UInt64 = 0                  // attribué à la capture (sessionQ uniquement)
+
+    init() {
+        slots = .allocate(capacity: FrameProfiler.capacity * FrameProfiler.words)
+        slots.initialize(repeating: 0, count: FrameProfiler.capacity * FrameProfiler.words)
+        drops = .allocate(capacity: DropReason.allCases.count)
+        drops.initialize(repeating: 0, count: DropReason.allCases.count)
+    }
+
+    deinit {
+        slots.deallocate()
+        drops.deallocate()
+    }
+
+    /// Remise à zéro entre deux sessions (aucun étage ne doit écrire pendant l'appel)
+    func reset() {
+        slots.update(repeating: 0, count: FrameProfiler.capacity * FrameProfiler.words)
+        drops.update(repeating: 0, count: DropReason.allCases.count)
+        nextId = 0
+    }
+
+    @inline(__always)
+    private func slot(_ id: UInt64) -> UnsafeMutablePointer<UInt64> {
+        slots + Int(id % UInt64(FrameProfiler.capacity)) * FrameProfiler.words
+    }
+
+    // Champs lus par les stats pendant qu'un étage les écrit : accès atomiques relaxed,
+    // l'ordre est donné par le mot de commit et les barrières
+    @inline(__always)
+    private func put(_ s: UnsafeMutablePointer<UInt64>, _ f: F, _ v: UInt64) { wcs_store_relaxed(s + f.rawValue, v) }
+
+    @inline(__always)
+    private func get(_ s: UnsafeMutablePointer<UInt64>, _ f: F) -> UInt64 { wcs_load_relaxed(s + f.rawValue) }
+
+    // MARK: Écriture (hot path)
+
+    /// Capture : attribue l'id et invalide le slot avant de le réutiliser.
+    func beginFrame(captureNs: UInt64) -> UInt64 {
+        let id = nextId
+        nextId &+= 1
+        let s = slot(id)
+        wcs_store_release(s, 0)
+        wcs_fence_release() // slot invalidé avant que les champs réécrits deviennent visibles
+        for i in 1..<FrameProfiler.words { wcs_store_relaxed(s + i, 0) }
+        put(s, .capture, captureNs)
+        return id
+    }
+
+    func submitted(_ id: UInt64, start: UInt64, end: UInt64) {
+        let s = slot(id)
+        put(s, .submitStart, start)
+        put(s, .submitEnd, end)
+    }
+
+    func encoded(_ id: UInt64, at ns: UInt64, bytes: Int, isKey: Bool) {
+        let s = slot(id)
+        put(s, .encodeDone, ns)
+        put(s, .bytes, UInt64(bytes))
+        put(s, .flags, isKey ? 1 : 0)
+    }
+
+    func sent(_ id: UInt64, at ns: UInt64) {
+        let s = slot(id)
+        put(s, .sendDone, ns)
+        wcs_store_release(s, id &+ 1)
+    }
+
+    func dropped(_ id: UInt64, reason: DropReason) {
+        let s = slot(id)
+        put(s, .flags, get(s, .flags) | reason.rawValue << 8)
+        wcs_fetch_add(drops + Int(reason.rawValue), 1)
+        wcs_store_release(s, id &+ 1)
+    }
+
+    // MARK: Lecture (stats)
+
+    /// Frames publiées encore présentes dans le ring (fenêtre glissante ~capacity frames)
+    func snapshot() -> [Record] {
+        var out: [Record] = []
+        out.reserveCapacity(FrameProfiler.capacity)
+        for i in 0..<FrameProfiler.capacity {
+            let s = slots + i * FrameProfiler.words
+            let c0 = wcs_load_acquire(s)
+            guard c0 != 0 else { continue }
+            let flags = get(s, .flags)
+            let r = Record(id: c0 - 1,
+                           captureNs: get(s, .capture),
+                           submitStartNs: get(s, .submitStart),
+                           submitEndNs: get(s, .submitEnd),
+                           encodeDoneNs: get(s, .encodeDone),
+                           sendDoneNs: get(s, .sendDone),
+                           bytes: Int(get(s, .bytes)),
+                           isKey: flags & 1 != 0,
+                           drop: DropReason(rawValue: (flags >> 8) & 0xFF) ?? .none)
+            wcs_fence_acquire()
+            guard wcs_load_relaxed(s) == c0 else { continue } // réécrit pendant la copie
+            out.append(r)
+        }
+        return out
+    }
+
+    func dropCount(_ r: DropReason) -> UInt64 { wcs_load_relaxed(drops + Int(r.rawValue)) }
+
+    /// Percentile du temps d'encodage seul (soumission → sortie VT) sur les frames envoyées (ms),
+    /// nil si aucune. Sans le délai du pipeline capture, comparable à un intervalle de frame.
+    func encodeTime(percentile p: Double) -> Double? {
+        let v = snapshot().filter { $0.drop == .none && $0.submitStartNs != 0 }.map { $0.encodeTime }.sorted()
+        guard !v.isEmpty else { return nil }
+        return v[min(v.count - 1, Int(Double(v.count - 1) * p))]
+    }
+
+    /// Résumé pour l'overlay : percentiles p50/p95/p99 + compteurs de drops
+    func summary() -> String {
+        let recs = snapshot()
+        let sent = recs.filter { $0.drop == .none }
+        func pct(_ v: [Double]) -> String {
+            guard !v.isEmpty else { return "-" }
+            let s = v.sorted()
+            func at(_ p: Double) -> Double { s[min(s.count - 1, Int(Double(s.count - 1) * p))] }
+            return String(format: "%.1f/%.1f/%.1f", at(0.50), at(0.95), at(0.99))
+        }
+        let enc = pct(sent.map { $0.encodeLatency })
+        let net = pct(sent.map { $0.sendLatency })
+        let sub = pct(sent.map { $0.submitDuration })
+        let d = DropReason.allCases.filter { $0 != .none }
+            .map { "\($0.label) \(dropCount($0))" }.joined(separator: " ")
+        return "p50/95/99 ms • enc \(enc) • net \(net) • submit \(sub)\ndrops: \(d)"
+    }
+}
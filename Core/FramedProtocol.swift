@@ -0,0 +1,44 @@
+import Foundation
+
+/// En-tête du protocole `.framed` : une access unit Annex-B par trame, précédée de
+/// 24 octets fixes (big-endian). Le lecteur lit l'en-tête puis exactement `length`
+/// octets — deux recv par frame, sans parser le bitstream pour trouver les AU.
+///   0  magic 'WCSF'
+///   4  version u8 (1)
+///   5  codec u8 (0 = H.264, 1 = HEVC)
+///   6  flags u8 (bit0 keyframe, bit1 parameter sets présents, bit2 SEI latence,
+///      bit3 hors séquence : parameter sets seuls envoyés à la connexion, seq = 0,
+///      à ignorer pour la détection de pertes)
+///   7  taille de l'en-tête u8 (24, pour extensions futures)
+///   8  seq u32 : attribué après l'admission commune, donc seulement aux frames qu'au
+///      moins un lecteur peut prendre. Un trou = frame jetée par la file d'envoi de CE
+///      lecteur. Les frames sautées avant l'encodage ou refusées par tous les lecteurs
+///      ne laissent pas de trou : la cadence réelle se lit sur le PTS.
+///  12  PTS de capture u64 (ns, HostClock)
+///  20  longueur du payload u32
+enum FrameHeader {
+    static let size = 24
+    static let magic: [UInt8] = [0x57, 0x43, 0x53, 0x46] // "WCSF"
+
+    struct Flags: OptionSet {
+        let rawValue: UInt8
+        static let keyframe  = Flags(rawValue: 1 << 0)
+        static let config    = Flags(rawValue: 1 << 1)
+        static let latency   = Flags(rawValue: 1 << 2)
+        static let outOfSequence = Flags(rawValue: 1 << 3)
+    }
+
+    static func make(hevc: Bool, flags: Flags, seq: UInt32, ptsNs: UInt64, length: Int) -> DispatchData {
+        var h = magic
+        h.reserveCapacity(size)
+        h.append(1)
+        h.append(hevc ? 1 : 0)
+        h.append(flags.rawValue)
+        h.append(UInt8(size))
+        for s in stride(from: 24, through: 0, by: -8) { h.append(UInt8(truncatingIfNeeded: seq >> UInt32(s))) }
+        for s in stride(from: 56, through: 0, by: -8) { h.append(UInt8(truncatingIfNeeded: ptsNs >> UInt64(s))) }
+        let len = UInt32(truncatingIfNeeded: length)
+        for s in stride(from: 24, through: 0, by: -8) { h.append(UInt8(truncatingIfNeeded: len >> UInt32(s))) }
+        return h.withUnsafeBytes { DispatchData(bytes: $0) }
+    }
+}
@@ -0,0 +1,100 @@
+import Foundation
+
+/// État partagé entre les files du pipeline, en atomiques : ni verrou ni saut de
+/// queue par frame. Chaque mot a un propriétaire explicite :
+///   idrRequest  — posé par n'importe qui (UI, lecteurs, files), consommé par la capture (sessionQ)
+///   generation  — écrit par controlQ au start, lu par les complétions réseau
+///   frameSeq    — pris par le thread VT (seul producteur), remis à zéro par controlQ au start
+///   window      — frames (16 bits hauts) + octets (48 bits bas) dans un seul mot : incrémenté
+///                 par le thread VT, relevé et remis à zéro d'un coup par les stats (main)
+///   handOff*    — incrémentés par la capture (sessionQ), relevés par les stats (main)
+///   reconfigure* — début posé par sessionQ, clos par le thread VT à la première frame, lu par les stats
+final class HotPathState {
+    private enum W: Int, CaseIterable {
+        case idrRequest = 0, generation, frameSeq, window
+        case handOffDirect, handOffConverted, reconfigureStart, reconfigureNs
+    }
+
+    private let words: UnsafeMutablePointer<UInt64>
+
+    init() {
+        words = .allocate(capacity: W.allCases.count)
+        words.initialize(repeating: 0, count: W.allCases.count)
+    }
+
+    deinit { words.deallocate() }
+
+    @inline(__always)
+    private func p(_ w: W) -> UnsafeMutablePointer<UInt64> { words + w.rawValue }
+
+    // MARK: IDR
+
+    func requestIDR() { wcs_store_release(p(.idrRequest), 1) }
+
+    /// true une seule fois par demande, même si plusieurs demandes se sont cumulées
+    func takeIDRRequest() -> Bool { wcs_exchange(p(.idrRequest), 0) != 0 }
+
+    // MARK: Session
+
+    var generation: UInt64 { wcs_load_acquire(p(.generation)) }
+
+    /// Nouvelle session : les complétions de l'ancienne deviennent sans effet
+    @discardableResult
+    func nextGeneration() -> UInt64 {
+        let g = wcs_load_relaxed(p(.generation)) &+ 1
+        wcs_store_release(p(.generation), g)
+        return g
+    }
+
+    // MARK: Séquence de frames
+
+    func takeFrameSeq() -> UInt32 { UInt32(truncatingIfNeeded: wcs_fetch_add(p(.frameSeq), 1)) }
+
+    func resetFrameSeq() { wcs_store_relaxed(p(.frameSeq), 0) }
+
+    // MARK: Fenêtre de stats
+
+    // 2^48 o ≈ 281 To par fenêtre de 1 s, 65535 frames : aucun débordement possible
+    private static let bytesMask: UInt64 = (1 << 48) - 1
+
+    func countFrame(bytes: Int) {
+        wcs_fetch_add(p(.window), 1 << 48 | (UInt64(bytes) & HotPathState.bytesMask))
+    }
+
+    /// Relevé + remise à zéro en un seul échange : une frame n'est jamais coupée entre deux fenêtres
+    func takeWindow() -> (frames: Int, bytes: Int) {
+        let w = wcs_exchange(p(.window), 0)
+        return (Int(w >> 48), Int(w & HotPathState.bytesMask))
+    }
+
+    // MARK: Hand-off capture → encodeur
+
+    /// `direct` : buffer IOSurface au format et aux dimensions de la session VT (aucune conversion)
+    func countHandOff(direct: Bool) {
+        wcs_fetch_add(p(direct ? .handOffDirect : .handOffConverted), 1)
+    }
+
+    func takeHandOff() -> (direct: Int, converted: Int) {
+        let d = wcs_exchange(p(.handOffDirect), 0)
+        let c = wcs_exchange(p(.handOffConverted), 0)
+        return (Int(d), Int(c))
+    }
+
+    // MARK: Reconfiguration
+
+    func beginReconfigure(at ns: UInt64) { wcs_store_release(p(.reconfigureStart), ns) }
+
+    /// Clôt une reconfiguration en cours (une seule fois) : durée jusqu'à la première frame encodée
+    func endReconfigure(at ns: UInt64) {
+        guard wcs_load_relaxed(p(.reconfigureStart)) != 0 else { return }
+        let start = wcs_exchange(p(.reconfigureStart), 0)
+        guard start != 0, ns > start else { return }
+        wcs_store_release(p(.reconfigureNs), ns - start)
+    }
+
+    /// Durée de la dernière reconfiguration (arrêt VT → première frame), nil si aucune
+    var lastReconfigureMs: Double? {
+        let ns = wcs_load_acquire(p(.reconfigureNs))
+        return ns == 0 ? nil : Double(ns) / 1_000_000
+    }
+}
@@ -0,0 +1,126 @@
+import Foundation
+import CoreMedia
+
+/// Horloge hôte en ns (mach_absolute_time) : celle des PTS de capture AVFoundation.
+enum HostClock {
+    static func now() -> UInt64 { DispatchTime.now().uptimeNanoseconds }
+
+    static func nanos(_ t: CMTime) -> UInt64 {
+        guard t.isValid, t.value >= 0 else { return 0 }
+        return UInt64(CMTimeConvertScale(t, timescale: 1_000_000_000, method: .roundHalfAwayFromZero).value)
+    }
+}
+
+/// État de l'instrumentation, par lecteur : chacun a ses fins d'envoi (sa file jette ses
+/// propres frames) et son ping d'horloge en attente. Le SEI, commun à tous les lecteurs,
+/// ne décrit qu'UN lecteur par frame, désigné par son id : d'abord celui dont l'écho est
+/// prêt, sinon chacun son tour.
+final class LatencyTracker {
+    struct ClockEcho { var t0: UInt64; var t1: UInt64 }
+    struct Tag {
+        var client: Int
+        var lastSent: (seq: UInt32, ns: UInt64)
+        var echo: ClockEcho?
+    }
+
+    private struct Entry {
+        var lastSent: (seq: UInt32, ns: UInt64)?
+        var pendingEcho: ClockEcho?
+    }
+
+    private let lock = NSLock() // VT (lecture) / queues réseau (écriture)
+    private var entries: [Int: Entry] = [:]
+    private var turn = 0 // dernier lecteur annoncé hors écho
+
+    func reset() {
+        lock.lock(); defer { lock.unlock() }
+        entries = [:]; turn = 0
+    }
+
+    /// Fin d'envoi d'une frame chez `client` : seule frame dont ce lecteur connaît l'arrivée
+    func sendCompleted(client: Int, seq: UInt32, at ns: UInt64) {
+        lock.lock(); defer { lock.unlock() }
+        entries[client, default: Entry()].lastSent = (seq, ns)
+    }
+
+    func clockPing(client: Int, t0: UInt64, receivedAt t1: UInt64) {
+        lock.lock(); defer { lock.unlock() }
+        entries[client, default: Entry()].pendingEcho = ClockEcho(t0: t0, t1: t1)
+    }
+
+    /// Lecteur à décrire dans la prochaine frame, choisi parmi `candidates` (ceux qui la
+    /// prendront a priori) ; les lecteurs absents de `readers` sont oubliés. L'écho n'est
+    /// renvoyé qu'une fois, et seulement quand la dernière fin d'envoi de CE lecteur est
+    /// postérieure à son ping (elle sert de t2).
+    func take(readers: [Int], candidates: [Int]) -> Tag? {
+        lock.lock(); defer { lock.unlock() }
+        entries = entries.filter { readers.contains($0.key) }
+        let ready = entries.first { entry in
+            guard candidates.contains(entry.key),
+                  let p = entry.value.pendingEcho, let sent = entry.value.lastSent else { return false }
+            return sent.ns >= p.t1
+        }
+        if let hit = ready, let sent = hit.value.lastSent {
+            entries[hit.key]?.pendingEcho = nil
+            return Tag(client: hit.key, lastSent: sent, echo: hit.value.pendingEcho)
+        }
+        let ids = entries.filter { candidates.contains($0.key) && $0.value.lastSent != nil }.keys.sorted()
+        guard let id = ids.first(where: { $0 > turn }) ?? ids.first,
+              let sent = entries[id]?.lastSent else { return nil }
+        turn = id
+        return Tag(client: id, lastSent: sent, echo: nil)
+    }
+}
+
+/// SEI user_data_unregistered (payloadType 5) porteur des horodatages de latence.
+/// Payload après l'UUID, big-endian :
+///   version u8 | flags u8 (bit0 = envoi précédent, bit1 = écho d'horloge) | seq u32 |
+///   capture ns u64 | fin d'encodage ns u64 |
+///   lecteur u8 | seq envoyée u32 | fin d'envoi ns u64 |
+///   t0 lecteur u64 | t1 réception ping u64 | t2 u64
+/// Horloge iPhone = HostClock. Le SEI part vers tous les lecteurs mais `seq envoyée`,
+/// `fin d'envoi` et l'écho concernent le seul `lecteur` (id sur 8 bits) : un lecteur
+/// apprend son id au premier écho portant un t0 qu'il a envoyé, et ignore les autres.
+/// t2 = fin d'envoi de `seq envoyée` chez ce lecteur, postérieure à t1 ; t3 = arrivée de
+/// cette frame chez lui. Le lecteur calcule offset = ((t1 - t0) + (t2 - t3)) / 2. Un écho
+/// porté par une frame que sa file a jetée est perdu : le lecteur repinge.
+enum LatencySEI {
+    static let uuid: [UInt8] = [0x57, 0x43, 0x53, 0x4C, 0x41, 0x54, 0x45, 0x4E, // "WCSLATEN"
+                                0x43, 0x59, 0x00, 0x01, 0x9E, 0x1B, 0x4D, 0x21]
+
+    static func make(hevc: Bool, seq: UInt32, captureNs: UInt64, encodeDoneNs: UInt64,
+                     tag: LatencyTracker.Tag?) -> Data {
+        let echo = tag?.echo
+        var p: [UInt8] = uuid
+        p.reserveCapacity(uuid.count + 59)
+        func put32(_ v: UInt32) { for s in stride(from: 24, through: 0, by: -8) { p.append(UInt8(truncatingIfNeeded: v >> UInt32(s))) } }
+        func put64(_ v: UInt64) { for s in stride(from: 56, through: 0, by: -8) { p.append(UInt8(truncatingIfNeeded: v >> UInt64(s))) } }
+
+        p.append(3) // v3 : envoi précédent et écho propres à un lecteur
+        p.append((tag != nil ? 0x01 : 0) | (echo != nil ? 0x02 : 0))
+        put32(seq)
+        put64(captureNs)
+        put64(encodeDoneNs)
+        p.append(UInt8(truncatingIfNeeded: tag?.client ?? 0))
+        put32(tag?.lastSent.seq ?? 0)
+        put64(tag?.lastSent.ns ?? 0)
+        put64(echo?.t0 ?? 0)
+        put64(echo?.t1 ?? 0)
+        put64(echo != nil ? (tag?.lastSent.ns ?? 0) : 0)
+
+        // sei_message : type 5, taille (< 255 ici), payload, puis rbsp_trailing_bits
+        var rbsp: [UInt8] = [5, UInt8(p.count)]
+        rbsp += p
+        rbsp.append(0x80)
+
+        var nal: [UInt8] = hevc ? [39 << 1, 0x01] : [0x06] // prefix SEI HEVC / SEI H.264
+        // Emulation prevention : 00 00 0x (x ≤ 3) → 00 00 03 0x
+        var zeros = 0
+        for b in rbsp {
+            if zeros >= 2 && b <= 3 { nal.append(3); zeros = 0 }
+            nal.append(b)
+            zeros = b == 0 ? zeros + 1 : 0
+        }
+        return Data(nal)
+    }
+}
@@ -0,0 +1,186 @@
+import Foundation
+import CoreMedia
+
+/// Framing NAL commun H.264 / HEVC (VideoToolbox sort de l'AVCC/HVCC, longueurs 4o)
+enum NALPacker {
+    static func isHEVC(_ fmt: CMFormatDescription) -> Bool {
+        CMFormatDescriptionGetMediaSubType(fmt) == kCMVideoCodecType_HEVC
+    }
+
+    // Tous les parameter sets dans l'ordre du format :
+    // H.264 = SPS puis un ou plusieurs PPS, HEVC = VPS, SPS, PPS (…)
+    static func parameterSets(from fmt: CMFormatDescription) -> [Data]? {
+        let hevc = isHEVC(fmt)
+        func get(_ i: Int, _ ptr: UnsafeMutablePointer<UnsafePointer<UInt8>?>?,
+                 _ len: UnsafeMutablePointer<Int>?, _ count: UnsafeMutablePointer<Int>?) -> OSStatus {
+            hevc
+                ? CMVideoFormatDescriptionGetHEVCParameterSetAtIndex(fmt, parameterSetIndex: i,
+                    parameterSetPointerOut: ptr, parameterSetSizeOut: len, parameterSetCountOut: count,
+                    nalUnitHeaderLengthOut: nil)
+                : CMVideoFormatDescriptionGetH264ParameterSetAtIndex(fmt, parameterSetIndex: i,
+                    parameterSetPointerOut: ptr, parameterSetSizeOut: len, parameterSetCountOut: count,
+                    nalUnitHeaderLengthOut: nil)
+        }
+
+        var count = 0
+        guard get(0, nil, nil, &count) == noErr, count >= (hevc ? 3 : 2) else { return nil }
+
+        var sets: [Data] = []
+        sets.reserveCapacity(count)
+        for i in 0..<count {
+            var ptr: UnsafePointer<UInt8>?
+            var len = 0
+            guard get(i, &ptr, &len, nil) == noErr, let p = ptr else { return nil }
+            sets.append(Data(bytes: p, count: len))
+        }
+        return sets
+    }
+
+    // NAL hors bitstream (parameter sets, SEI) en Annex-B
+    static func annexBNALs(_ sets: [Data]) -> DispatchData {
+        var d = Data()
+        for ps in sets { d.append(contentsOf: [0, 0, 0, 1]); d.append(ps) }
+        return d.withUnsafeBytes { DispatchData(bytes: $0) }
+    }
+
+    // NAL hors bitstream en AVCC/HVCC (longueurs 4 octets)
+    static func avccNALs(_ sets: [Data]) -> DispatchData {
+        var d = Data()
+        for ps in sets {
+            let v = UInt32(ps.count)
+            d.append(contentsOf: [UInt8(truncatingIfNeeded: v >> 24),
+                                  UInt8(truncatingIfNeeded: v >> 16),
+                                  UInt8(truncatingIfNeeded: v >> 8),
+                                  UInt8(truncatingIfNeeded: v)])
+            d.append(ps)
+        }
+        return d.withUnsafeBytes { DispatchData(bytes: $0) }
+    }
+
+    /// Cache des parameter sets pré-framés, indexé par identité du CMFormatDescription.
+    /// VideoToolbox réutilise le même objet tant que SPS/PPS ne changent pas : on
+    /// n'extrait donc qu'à l'arrivée d'un nouveau format, pas à chaque frame.
+    final class ParameterSetCache {
+        private let lock = NSLock() // update (thread VT) / lecture à l'arrivée d'un lecteur
+        private var format: CMFormatDescription?
+        private var raw: [Data]?
+        private var annexB: DispatchData?
+        private var avcc: DispatchData?
+
+        /// Codec du format en cache (parameter sets envoyés hors frame)
+        var isHEVC: Bool {
+            lock.lock(); defer { lock.unlock() }
+            return format.map(NALPacker.isHEVC) ?? false
+        }
+
+        /// NAL bruts (RTP)
+        var sets: [Data]? {
+            lock.lock(); defer { lock.unlock() }
+            return raw
+        }
+
+        /// Met à jour le cache si `fmt` est nouveau. Renvoie true si les parameter sets ont changé.
+        @discardableResult
+        func update(with fmt: CMFormatDescription) -> Bool {
+            lock.lock(); defer { lock.unlock() }
+            if let cur = format {
+                if cur === fmt { return false }
+                // Nouvel objet mais contenu identique : on garde les blobs
+                if CMFormatDescriptionEqual(cur, otherFormatDescription: fmt) { format = fmt; return false }
+            }
+            guard let sets = NALPacker.parameterSets(from: fmt) else {
+                clear()
+                return false
+            }
+            format = fmt
+            raw = sets
+            annexB = NALPacker.annexBNALs(sets)
+            avcc = NALPacker.avccNALs(sets)
+            return true
+        }
+
+        func framed(for proto: OutputProtocol) -> DispatchData? {
+            lock.lock(); defer { lock.unlock() }
+            switch proto {
+            case .annexb, .framed: return annexB
+            case .avcc:   return avcc
+            case .rtp:    return nil // paquetisés individuellement
+            }
+        }
+
+        func reset() {
+            lock.lock(); defer { lock.unlock() }
+            clear()
+        }
+
+        private func clear() { format = nil; raw = nil; annexB = nil; avcc = nil }
+    }
+
+    // Start code Annex-B partagé (petit buffer annexe, jamais recopié)
+    private static let startCode: DispatchData = [UInt8]([0, 0, 0, 1]).withUnsafeBytes { DispatchData(bytes: $0) }
+
+    // Sous-plage du CMBlockBuffer en DispatchData sans copie : chaque région pointe
+    // dans la mémoire VT et retient le block buffer jusqu'à la fin de l'envoi.
+    static func dispatchData(_ bb: CMBlockBuffer, offset: Int, length: Int) -> DispatchData? {
+        var out = DispatchData.empty
+        var off = offset
+        let end = offset + length
+        while off < end {
+            var lengthAtOffset = 0
+            var dataPtr: UnsafeMutablePointer<Int8>?
+            let ok = CMBlockBufferGetDataPointer(bb, atOffset: off,
+                                                 lengthAtOffsetOut: &lengthAtOffset,
+                                                 totalLengthOut: nil,
+                                                 dataPointerOut: &dataPtr)
+            guard ok == noErr, let p = dataPtr, lengthAtOffset > 0 else { return nil }
+            let n = min(lengthAtOffset, end - off)
+            let region = DispatchData(bytesNoCopy: UnsafeRawBufferPointer(start: p, count: n),
+                                      deallocator: .custom(nil, { withExtendedLifetime(bb) {} }))
+            out.append(region)
+            off += n
+        }
+        return out
+    }
+
+    // AVCC → Annex-B : on remplace chaque longueur 4o par un start code, le NAL reste en place
+    static func annexBFromSampleBuffer(dataBuffer: CMBlockBuffer) -> DispatchData? {
+        let totalLength = CMBlockBufferGetDataLength(dataBuffer)
+        var out = DispatchData.empty
+        var offset = 0
+        var lenBE: UInt32 = 0
+        while offset + 4 <= totalLength {
+            guard CMBlockBufferCopyDataBytes(dataBuffer, atOffset: offset, dataLength: 4,
+                                             destination: &lenBE) == noErr else { return nil }
+            let nalLen = Int(CFSwapInt32BigToHost(lenBE))
+            let naluStart = offset + 4
+            let naluEnd = naluStart + nalLen
+            guard naluEnd <= totalLength,
+                  let nal = dispatchData(dataBuffer, offset: naluStart, length: nalLen) else { break }
+            out.append(startCode)
+            out.append(nal)
+            offset = naluEnd
+        }
+        return out.isEmpty ? nil : out
+    }
+
+    // AVCC brut (conserve les longueurs 4o) : le block buffer tel quel, sans copie
+    static func rawFromSampleBuffer(dataBuffer: CMBlockBuffer) -> DispatchData? {
+        let totalLength = CMBlockBufferGetDataLength(dataBuffer)
+        guard totalLength > 0 else { return nil }
+        return dispatchData(dataBuffer, offset: 0, length: totalLength)
+    }
+
+    // DispatchData → une Data par région contiguë, pointant sur la mémoire d'origine
+    // (retient `d`). Pas de Data(referencing:) sur le tout : -[NSData bytes] d'un
+    // dispatch_data multi-régions aplatit l'access unit entière dans un nouveau buffer.
+    // Les régions s'envoient l'une après l'autre (isComplete sur la dernière seulement).
+    static func contiguousRegions(_ d: DispatchData) -> [Data] {
+        var out: [Data] = []
+        d.enumerateBytes { buf, _, _ in
+            guard let base = buf.baseAddress, buf.count > 0 else { return }
+            out.append(Data(bytesNoCopy: UnsafeMutableRawPointer(mutating: base), count: buf.count,
+                            deallocator: .custom { _, _ in withExtendedLifetime(d) {} }))
+        }
+        return out
+    }
+}
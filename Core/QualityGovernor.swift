@@ -0,0 +1,94 @@
+import Foundation
+
+/// Gouverneur thermique : dégrade la qualité par paliers avant que iOS ne bride
+/// caméra et encodeur (cadence qui s'effondre de façon imprévisible).
+/// Entrées par fenêtre de stats : `ProcessInfo.thermalState` + p95 du temps
+/// d'encodage (soumission → sortie VT, sans le délai capteur → app, qui dépasse
+/// seul une période à 120 fps). Descente rapide, remontée lente (hystérésis).
+/// `evaluate` tourne sur le timer de stats ; `degrade` est pur (appelé sur controlQ).
+final class QualityGovernor {
+    /// Paliers cumulés : 1 = fps ≤ 60, 2 = débit x0.7, 3 = résolution -1 cran, 4 = fps ≤ 30
+    static let maxLevel = 4
+
+    private(set) var level = 0
+
+    private let hotWindowsToStepDown = 2   // 1 seule en .critical
+    private let coolWindowsToStepUp = 30   // ~30 s à froid avant de remonter d'un palier
+    private let holdWindowsAfterChange = 5 // laisse l'effet du palier se voir
+
+    private var hotStreak = 0
+    private var coolStreak = 0
+    private var hold = 0
+
+    func reset() {
+        level = 0
+        hotStreak = 0; coolStreak = 0; hold = 0
+    }
+
+    /// Fin de fenêtre (1 Hz) : renvoie le nouveau palier s'il change.
+    func evaluate(thermal: ProcessInfo.ThermalState, encodeP95: Double?, frameInterval: Double) -> Int? {
+        let enc = encodeP95 ?? 0 // ms
+        let budget = frameInterval * 1000
+        // Chaud : l'OS va brider, ou l'encodeur ne tient déjà plus la cadence
+        let hot = thermal == .serious || thermal == .critical
+            || (thermal == .fair && enc > 0.8 * budget)
+            || enc > budget
+        // Froid : pas de pression thermique et de la marge à l'encodage
+        let cool = thermal == .nominal && enc < 0.5 * budget
+
+        if hold > 0 { hold -= 1; return nil }
+
+        var next = level
+        if hot {
+            coolStreak = 0
+            hotStreak += 1
+            if hotStreak >= (thermal == .critical ? 1 : hotWindowsToStepDown) {
+                hotStreak = 0
+                next = min(QualityGovernor.maxLevel, level + 1)
+            }
+        } else if cool {
+            hotStreak = 0
+            coolStreak += 1
+            if coolStreak >= coolWindowsToStepUp {
+                coolStreak = 0
+                next = max(0, level - 1)
+            }
+        } else {
+            hotStreak = 0; coolStreak = 0
+        }
+
+        guard next != level else { return nil }
+        level = next
+        hold = holdWindowsAfterChange
+        return next
+    }
+
+    /// Réglages effectifs à un palier, à partir des réglages demandés
+    static func degrade(_ c: PendingConfig, level: Int) -> PendingConfig {
+        var out = c
+        if level >= 1 { out.fps = min(out.fps, 60) }
+        if level >= 2 {
+            out.bitrate *= 0.7
+            out.minBitrate = min(out.minBitrate, out.bitrate)
+        }
+        if level >= 3 {
+            switch out.resolution {
+            case .r4k:   out.resolution = .r1080p
+            case .r1080p: out.resolution = .r720p
+            case .r720p: break
+            }
+        }
+        if level >= 4 { out.fps = min(out.fps, 30) }
+        return out
+    }
+
+    static func label(_ level: Int) -> String {
+        switch level {
+        case 0: return "-"
+        case 1: return "fps≤60"
+        case 2: return "fps≤60 débit-30%"
+        case 3: return "fps≤60 débit-30% rés-1"
+        default: return "fps≤30 débit-30% rés-1"
+        }
+    }
+}
@@ -0,0 +1,140 @@
+import Foundation
+import CoreMedia
+
+/// Paquetisation RTP H.264 (RFC 6184) / HEVC (RFC 7798) : single NAL unit ou
+/// fragmentation (FU-A / FU type 49), découpée directement depuis les longueurs
+/// AVCC du sample buffer. Chaque paquet est un en-tête de quelques octets + une
+/// sous-plage du CMBlockBuffer (sans copie).
+final class RTPPacketizer {
+    static let clockRate: Int32 = 90_000
+    static let headerSize = 12
+
+    let hevc: Bool
+    let payloadType: UInt8
+    let maxPayload: Int          // charge utile RTP max (MTU - IP/UDP - RTP)
+    let ssrc: UInt32
+    private var seq: UInt16
+
+    /// Séquence du prochain paquet émis (les paquets d'une frame sont consécutifs)
+    var nextSequenceNumber: UInt16 { seq }
+
+    init(mtu: Int = 1400, payloadType: UInt8 = 96, hevc: Bool = false) {
+        self.hevc = hevc
+        self.payloadType = payloadType
+        self.maxPayload = mtu - 28 - RTPPacketizer.headerSize
+        self.ssrc = UInt32.random(in: 1...UInt32.max)
+        self.seq = UInt16.random(in: 0...UInt16.max)
+    }
+
+    /// Horodatage RTP 90 kHz dérivé du PTS de capture
+    static func timestamp(for pts: CMTime) -> UInt32 {
+        let t = CMTimeConvertScale(pts, timescale: clockRate, method: .roundHalfAwayFromZero)
+        return UInt32(truncatingIfNeeded: t.value)
+    }
+
+    /// Une access unit → datagrammes RTP. Bit marqueur sur le dernier paquet.
+    func packetize(dataBuffer: CMBlockBuffer, prefixNALs: [Data], pts: CMTime) -> [DispatchData] {
+        let ts = RTPPacketizer.timestamp(for: pts)
+
+        // Plages (offset, longueur) des NAL dans le block buffer
+        let totalLength = CMBlockBufferGetDataLength(dataBuffer)
+        var nals: [(Int, Int)] = []
+        var offset = 0
+        var lenBE: UInt32 = 0
+        while offset + 4 <= totalLength {
+            guard CMBlockBufferCopyDataBytes(dataBuffer, atOffset: offset, dataLength: 4,
+                                             destination: &lenBE) == noErr else { break }
+            let nalLen = Int(CFSwapInt32BigToHost(lenBE))
+            guard nalLen > 0, offset + 4 + nalLen <= totalLength else { break }
+            nals.append((offset + 4, nalLen))
+            offset += 4 + nalLen
+        }
+        guard !nals.isEmpty else { return [] }
+
+        var out: [DispatchData] = []
+        out.reserveCapacity(nals.count + totalLength / maxPayload + 4)
+
+        // Parameter sets / SEI devant les slices (fragmentés s'ils dépassent un paquet)
+        for ps in prefixNALs where !ps.isEmpty {
+            guard ps.count > maxPayload else {
+                var pkt = header(marker: false, timestamp: ts)
+                ps.withUnsafeBytes { pkt.append($0) }
+                out.append(pkt)
+                continue
+            }
+            let base = ps.startIndex
+            fragment(nalHeader: [ps[base], ps.count > 1 ? ps[base + 1] : 0], length: ps.count,
+                     marker: false, timestamp: ts, into: &out) { o, n in
+                ps[(base + o)..<(base + o + n)].withUnsafeBytes { DispatchData(bytes: $0) }
+            }
+        }
+
+        for (i, (start, len)) in nals.enumerated() {
+            let lastNAL = i == nals.count - 1
+            if len <= maxPayload {
+                guard let body = NALPacker.dispatchData(dataBuffer, offset: start, length: len) else { continue }
+                var pkt = header(marker: lastNAL, timestamp: ts)
+                pkt.append(body)
+                out.append(pkt)
+                continue
+            }
+
+            var nalHeader: [UInt8] = [0, 0]
+            guard CMBlockBufferCopyDataBytes(dataBuffer, atOffset: start, dataLength: hevc ? 2 : 1,
+                                             destination: &nalHeader) == noErr else { continue }
+            fragment(nalHeader: nalHeader, length: len, marker: lastNAL, timestamp: ts, into: &out) { o, n in
+                NALPacker.dispatchData(dataBuffer, offset: start + o, length: n)
+            }
+        }
+        return out
+    }
+
+    /// Fragmentation : l'en-tête NAL (1o H.264, 2o HEVC) est remplacé par
+    /// FU indicator + FU header (H.264) ou PayloadHdr type 49 + FU header (HEVC).
+    /// `body(offset, n)` : octets du NAL à partir de son début.
+    private func fragment(nalHeader: [UInt8], length len: Int, marker: Bool, timestamp ts: UInt32,
+                          into out: inout [DispatchData], body: (Int, Int) -> DispatchData?) {
+        let nalHeaderSize = hevc ? 2 : 1
+        let prefix: [UInt8]
+        let type: UInt8
+        if hevc {
+            prefix = [(nalHeader[0] & 0x81) | (49 << 1), nalHeader[1]]
+            type = (nalHeader[0] >> 1) & 0x3F
+        } else {
+            prefix = [(nalHeader[0] & 0xE0) | 28]
+            type = nalHeader[0] & 0x1F
+        }
+        let chunk = maxPayload - prefix.count - 1
+        var pos = nalHeaderSize
+        while pos < len {
+            let n = min(chunk, len - pos)
+            let first = pos == nalHeaderSize
+            let last = pos + n == len
+            var fu = type
+            if first { fu |= 0x80 }
+            if last  { fu |= 0x40 }
+            guard let b = body(pos, n) else { break }
+            var pkt = header(marker: marker && last, timestamp: ts)
+            (prefix + [fu]).withUnsafeBytes { pkt.append($0) }
+            pkt.append(b)
+            out.append(pkt)
+            pos += n
+        }
+    }
+
+    // En-tête RTP fixe : V=2, pas de padding/extension/CSRC
+    private func header(marker: Bool, timestamp ts: UInt32) -> DispatchData {
+        let s = seq
+        seq &+= 1
+        let h: [UInt8] = [
+            0x80,
+            (marker ? 0x80 : 0) | (payloadType & 0x7F),
+            UInt8(truncatingIfNeeded: s >> 8), UInt8(truncatingIfNeeded: s),
+            UInt8(truncatingIfNeeded: ts >> 24), UInt8(truncatingIfNeeded: ts >> 16),
+            UInt8(truncatingIfNeeded: ts >> 8), UInt8(truncatingIfNeeded: ts),
+            UInt8(truncatingIfNeeded: ssrc >> 24), UInt8(truncatingIfNeeded: ssrc >> 16),
+            UInt8(truncatingIfNeeded: ssrc >> 8), UInt8(truncatingIfNeeded: ssrc)
+        ]
+        return h.withUnsafeBytes { DispatchData(bytes: $0) }
+    }
+}
@@ -0,0 +1,135 @@
+import Foundation
+
+/// FEC XOR par groupes de K paquets (une perte récupérable par groupe).
+/// Paquet de parité = en-tête RTP (PT 127, flux à part comme en RFC 5109 : SSRC
+/// propre = SSRC média + 1, séquence propre, même timestamp) puis : seq de base (u16) | K (u8) | 0 (u8) | XOR des longueurs (u16) | XOR des
+/// paquets RTP complets, complétés par des zéros à la longueur du plus long.
+/// Le lecteur reconstruit le paquet manquant (en-tête compris) en XORant le reste.
+final class RTPFECEncoder {
+    static let payloadType: UInt8 = 127
+
+    let ssrc: UInt32 // flux FEC : le suivi de séquence média du lecteur n'y voit pas de trous
+    private var seq = UInt16.random(in: 0...UInt16.max)
+    private var acc: [UInt8] = [] // réutilisé d'une frame à l'autre
+
+    init(mediaSSRC: UInt32) { self.ssrc = mediaSSRC &+ 1 }
+
+    /// Médias + parités intercalées (une parité après chaque groupe complet ou final)
+    func protect(_ media: [DispatchData], firstSeq: UInt16, timestamp ts: UInt32, groupSize k: Int) -> [DispatchData] {
+        guard k > 1, !media.isEmpty else { return media }
+        var out: [DispatchData] = []
+        out.reserveCapacity(media.count + media.count / k + 1)
+
+        var g = 0
+        while g < media.count {
+            let group = media[g..<min(g + k, media.count)]
+            out.append(contentsOf: group)
+            out.append(parity(group, baseSeq: firstSeq &+ UInt16(truncatingIfNeeded: g), timestamp: ts))
+            g += k
+        }
+        return out
+    }
+
+    private func parity(_ group: ArraySlice<DispatchData>, baseSeq: UInt16, timestamp ts: UInt32) -> DispatchData {
+        let maxLen = group.reduce(0) { max($0, $1.count) }
+        if acc.count < maxLen { acc = [UInt8](repeating: 0, count: maxLen) }
+        var lenXor: UInt16 = 0
+        acc.withUnsafeMutableBufferPointer { a in
+            for i in 0..<maxLen { a[i] = 0 }
+            for pkt in group {
+                lenXor ^= UInt16(truncatingIfNeeded: pkt.count)
+                pkt.enumerateBytes { buf, off, _ in
+                    for j in 0..<buf.count { a[off + j] ^= buf[j] }
+                }
+            }
+        }
+
+        let s = seq
+        seq &+= 1
+        let hdr: [UInt8] = [
+            0x80, RTPFECEncoder.payloadType,
+            UInt8(truncatingIfNeeded: s >> 8), UInt8(truncatingIfNeeded: s),
+            UInt8(truncatingIfNeeded: ts >> 24), UInt8(truncatingIfNeeded: ts >> 16),
+            UInt8(truncatingIfNeeded: ts >> 8), UInt8(truncatingIfNeeded: ts),
+            UInt8(truncatingIfNeeded: ssrc >> 24), UInt8(truncatingIfNeeded: ssrc >> 16),
+            UInt8(truncatingIfNeeded: ssrc >> 8), UInt8(truncatingIfNeeded: ssrc),
+            UInt8(truncatingIfNeeded: baseSeq >> 8), UInt8(truncatingIfNeeded: baseSeq),
+            UInt8(truncatingIfNeeded: group.count), 0,
+            UInt8(truncatingIfNeeded: lenXor >> 8), UInt8(truncatingIfNeeded: lenXor)
+        ]
+        var d = hdr.withUnsafeBytes { DispatchData(bytes: $0) }
+        acc.withUnsafeBytes { d.append(UnsafeRawBufferPointer(rebasing: $0[0..<maxLen])) }
+        return d
+    }
+}
+
+/// Historique des paquets envoyés pour les retransmissions sur NACK (RFC 4585).
+/// Un paquet n'est renvoyé que tant que sa frame est dans la deadline de latence ;
+/// au-delà le lecteur attend le prochain IDR, une retransmission serait inutile.
+final class RTPRetransmitHistory {
+    private struct Slot {
+        var seq: UInt16 = 0
+        var packet: DispatchData?
+        var deadline: UInt64 = 0 // uptime ns
+    }
+
+    private let lock = NSLock() // store (thread VT) / lookup (réception RTCP)
+    private var slots: [Slot]
+    private let mask: Int
+
+    // Puissance de 2. 2048 paquets de ~1200 o ≈ 2,4 Mo : ~100 ms au débit max (200 Mb/s),
+    // large devant la deadline NACK (16 ms par défaut). Un IDR 4K de plusieurs centaines
+    // de Ko occupe à lui seul 500+ slots : taille à revoir si la deadline monte.
+    init(capacity: Int = 2048) {
+        slots = [Slot](repeating: Slot(), count: capacity)
+        mask = capacity - 1
+    }
+
+    func store(_ packets: [DispatchData], firstSeq: UInt16, deadline: UInt64) {
+        lock.lock(); defer { lock.unlock() }
+        for (i, p) in packets.enumerated() {
+            let s = firstSeq &+ UInt16(truncatingIfNeeded: i)
+            slots[Int(s) & mask] = Slot(seq: s, packet: p, deadline: deadline)
+        }
+    }
+
+    func lookup(_ seq: UInt16, now: UInt64) -> DispatchData? {
+        lock.lock(); defer { lock.unlock() }
+        let slot = slots[Int(seq) & mask]
+        guard slot.seq == seq, now <= slot.deadline else { return nil }
+        return slot.packet
+    }
+
+    func reset() {
+        lock.lock(); defer { lock.unlock() }
+        for i in slots.indices { slots[i] = Slot() }
+    }
+
+    /// Numéros de séquence demandés par les Generic NACK d'un paquet RTCP (composé ou non)
+    static func parseNACK(_ data: Data) -> [UInt16] {
+        var lost: [UInt16] = []
+        let b = [UInt8](data)
+        var off = 0
+        while off + 4 <= b.count {
+            guard b[off] >> 6 == 2 else { break }
+            let fmt = b[off] & 0x1F
+            let pt = b[off + 1]
+            let len = ((Int(b[off + 2]) << 8 | Int(b[off + 3])) + 1) * 4
+            guard off + len <= b.count else { break }
+            if pt == 205 && fmt == 1 { // RTPFB / Generic NACK
+                var fci = off + 12
+                while fci + 4 <= off + len {
+                    let pid = UInt16(b[fci]) << 8 | UInt16(b[fci + 1])
+                    let blp = UInt16(b[fci + 2]) << 8 | UInt16(b[fci + 3])
+                    lost.append(pid)
+                    for bit in 0..<16 where blp & (1 << bit) != 0 {
+                        lost.append(pid &+ UInt16(bit + 1))
+                    }
+                    fci += 4
+                }
+            }
+            off += len
+        }
+        return lost
+    }
+}
@@ -0,0 +1,89 @@
+import Foundation
+
+/// File d'envoi bornée entre l'encodeur et le réseau (frames en vol + octets).
+/// Plusieurs frames peuvent être en cours d'envoi (pipelining), mais la latence
+/// reste bornée : au-delà de `depth` frames ou de `byteBudget` octets on jette.
+/// Les P sont jetées en premier ; un IDR a droit à un slot de réserve.
+final class SendQueue {
+    enum Decision {
+        case send
+        case drop          // frame jetée, rien d'autre à faire
+        case dropNeedsIDR  // référence cassée : le lecteur doit recevoir un IDR
+    }
+
+    private let lock = NSLock() // admit (thread VT) / complete (queue réseau)
+    private var depth: Int
+    private var byteBudget: Int
+    private var frames = 0
+    private var bytes = 0
+    private var awaitingIDR = false
+    private var joining = false // attente du premier IDR : pas une congestion
+    private var dropped = 0
+
+    init(depth: Int = 2, byteBudget: Int = 1 << 20) {
+        self.depth = max(1, depth)
+        self.byteBudget = max(1, byteBudget)
+    }
+
+    func configure(depth: Int, byteBudget: Int) {
+        lock.lock(); defer { lock.unlock() }
+        self.depth = max(1, depth)
+        self.byteBudget = max(1, byteBudget)
+    }
+
+    func reset() {
+        lock.lock(); defer { lock.unlock() }
+        frames = 0; bytes = 0; awaitingIDR = false; joining = false; dropped = 0
+    }
+
+    /// Nouveau lecteur : rien avant le prochain IDR (les P n'auraient pas de référence)
+    func awaitKeyframe() {
+        lock.lock(); defer { lock.unlock() }
+        awaitingIDR = true
+        joining = true
+    }
+
+    /// Plein pour une frame ordinaire : inutile d'encoder de nouvelles images.
+    var isSaturated: Bool {
+        lock.lock(); defer { lock.unlock() }
+        return frames >= depth || bytes >= byteBudget
+    }
+
+    /// Décide si une frame encodée part ; si oui elle est comptée en vol jusqu'à `complete`.
+    func admit(bytes n: Int, isKey: Bool) -> Decision {
+        lock.lock(); defer { lock.unlock() }
+        if joining && !isKey { return .drop }
+        let fits: Bool
+        if isKey {
+            // Slot de réserve + double budget : un IDR n'est jeté qu'en dernier recours
+            fits = frames == 0 || (frames <= depth && bytes + n <= 2 * byteBudget)
+        } else {
+            // Après une P jetée, les suivantes référencent une image absente : on attend l'IDR
+            fits = !awaitingIDR && (frames == 0 || (frames < depth && bytes + n <= byteBudget))
+        }
+        guard fits else {
+            dropped += 1
+            let wasAwaiting = awaitingIDR
+            awaitingIDR = true
+            return (isKey || !wasAwaiting) ? .dropNeedsIDR : .drop
+        }
+        if isKey { awaitingIDR = false; joining = false }
+        frames += 1
+        bytes += n
+        return .send
+    }
+
+    func complete(bytes n: Int) {
+        lock.lock(); defer { lock.unlock() }
+        frames = max(0, frames - 1)
+        bytes = max(0, bytes - n)
+    }
+
+    /// Frames jetées depuis le dernier appel (fenêtre de stats)
+    func takeDropped() -> Int {
+        lock.lock(); defer { lock.unlock() }
+        let d = dropped
+        dropped = 0
+        return d
+    }
+}
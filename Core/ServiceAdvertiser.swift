@@ -0,0 +1,32 @@
+import Foundation
+import Network
+
+/// Annonce Bonjour du listener (`_wincam._tcp`, `_wincam._udp` en RTP) : le lecteur
+/// trouve l'iPhone sans IP ni port à saisir et se connecte avant le Start.
+/// Le TXT décrit le flux courant pour préparer le décodeur avant la première frame :
+///   v=1  codec=h264|hevc|hevc10  res=1920x1080  fps=120  proto=annexb|avcc|framed|rtp  live=0|1
+enum ServiceAdvertiser {
+    static func type(udp: Bool) -> String { udp ? "_wincam._udp" : "_wincam._tcp" }
+
+    static func service(codec: VideoCodec, width: Int, height: Int, fps: Double,
+                        proto: OutputProtocol, live: Bool) -> NWListener.Service {
+        let txt = NWTXTRecord([
+            "v": "1",
+            "codec": codecKey(codec),
+            "res": "\(width)x\(height)",
+            "fps": "\(Int(fps))",
+            "proto": protoKey(proto),
+            "live": live ? "1" : "0"
+        ])
+        // Nom nil : nom de l'appareil (Réglages > Général > Informations)
+        return NWListener.Service(name: nil, type: type(udp: proto.usesUDP), domain: nil, txtRecord: txt)
+    }
+
+    private static func codecKey(_ c: VideoCodec) -> String {
+        switch c { case .h264: return "h264"; case .hevc: return "hevc"; case .hevc10: return "hevc10" }
+    }
+
+    private static func protoKey(_ p: OutputProtocol) -> String {
+        switch p { case .annexb: return "annexb"; case .avcc: return "avcc"; case .framed: return "framed"; case .rtp: return "rtp" }
+    }
+}
@@ -0,0 +1,125 @@
+import Foundation
+
+/// Enregistrement du flux encodé (archive QA) sans second encodeur : les frames
+/// déjà encodées sont écrites au format `.framed` (en-tête WCSF + access unit
+/// Annex-B, SPS/PPS sur chaque IDR), un fichier relisible tel quel par le lecteur.
+/// Écriture sur une queue basse priorité avec un tampon borné : si le disque
+/// traîne on jette des frames d'enregistrement (comptées), jamais des frames live.
+final class StreamRecorder {
+    static let maxPendingFrames = 60
+    static let maxPendingBytes = 64 << 20
+
+    private let queue = DispatchQueue(label: "Streamer.recorder", qos: .background)
+    private let lock = NSLock() // append (thread VT) / écriture (queue recorder) / stats (main)
+    private var handle: FileHandle?
+    private var pendingFrames = 0
+    private var pendingBytes = 0
+    private var awaitingKey = true // après un drop : reprise propre sur le prochain IDR
+    private var started = false    // premier IDR écrit : les frames sautées ensuite sont des drops
+    private var seq: UInt32 = 0    // propre au fichier : un trou = frame d'enregistrement jetée
+    private var written = 0
+    private var dropped = 0
+    private(set) var url: URL?
+
+    /// Appelé (hors verrou) quand une frame est jetée : un IDR au plus tôt pour reprendre
+    var onKeyframeNeeded: (() -> Void)?
+
+    var isRecording: Bool {
+        lock.lock(); defer { lock.unlock() }
+        return handle != nil
+    }
+
+    /// Nouveau fichier dans Documents (visible dans l'app Fichiers)
+    @discardableResult
+    func start() -> URL? {
+        let df = DateFormatter()
+        df.dateFormat = "yyyyMMdd-HHmmss"
+        guard let dir = FileManager.default.urls(for: .documentDirectory, in: .userDomainMask).first else { return nil }
+        let u = dir.appendingPathComponent("wincam-\(df.string(from: Date())).wcsf")
+        guard FileManager.default.createFile(atPath: u.path, contents: nil),
+              let h = try? FileHandle(forWritingTo: u) else { return nil }
+        lock.lock(); defer { lock.unlock() }
+        handle = h
+        url = u
+        pendingFrames = 0; pendingBytes = 0
+        awaitingKey = true
+        started = false
+        seq = 0; written = 0; dropped = 0
+        return u
+    }
+
+    func stop() {
+        lock.lock()
+        let h = handle
+        handle = nil
+        lock.unlock()
+        guard let h = h else { return }
+        queue.async { try? h.close() } // après les écritures déjà en file
+    }
+
+    /// Hot path : ne bloque jamais (au pire un verrou court), le bitstream est référencé sans copie.
+    /// `config` : parameter sets Annex-B, à fournir sur chaque IDR.
+    func append(hevc: Bool, isKey: Bool, config: DispatchData?, body: DispatchData, ptsNs: UInt64) {
+        lock.lock()
+        guard let h = handle else { lock.unlock(); return }
+        if awaitingKey && !isKey {
+            // Avant le premier IDR : rien à compter. Après un drop : P sans référence,
+            // jetée elle aussi et comptée (le trou de seq couvre toute l'attente)
+            if started { dropped += 1; seq &+= 1 }
+            lock.unlock()
+            return
+        }
+        let size = FrameHeader.size + (config?.count ?? 0) + body.count
+        guard pendingFrames < StreamRecorder.maxPendingFrames,
+              pendingBytes + size <= StreamRecorder.maxPendingBytes else {
+            dropped += 1
+            seq &+= 1
+            awaitingKey = true
+            let needKey = onKeyframeNeeded
+            lock.unlock()
+            needKey?()
+            return
+        }
+        let n = seq
+        seq &+= 1
+        awaitingKey = false
+        started = true
+        pendingFrames += 1
+        pendingBytes += size
+        lock.unlock()
+
+        var flags: FrameHeader.Flags = isKey ? [.keyframe] : []
+        var payload = DispatchData.empty
+        if let config = config {
+            payload.append(config)
+            flags.insert(.config)
+        }
+        payload.append(body)
+        var frame = FrameHeader.make(hevc: hevc, flags: flags, seq: n, ptsNs: ptsNs, length: payload.count)
+        frame.append(payload)
+
+        queue.async {
+            var failed = false
+            do {
+                for part in NALPacker.contiguousRegions(frame) { try h.write(contentsOf: part) }
+            } catch { failed = true }
+            self.lock.lock()
+            self.pendingFrames -= 1
+            self.pendingBytes -= size
+            if failed {
+                // Disque plein / fichier fermé : on arrête l'enregistrement, pas le live
+                if self.handle === h { self.handle = nil }
+            } else {
+                self.written += 1
+            }
+            self.lock.unlock()
+            if failed { try? h.close() }
+        }
+    }
+
+    /// Frames écrites / jetées depuis le début de l'enregistrement
+    var counters: (written: Int, dropped: Int) {
+        lock.lock(); defer { lock.unlock() }
+        return (written, dropped)
+    }
+}
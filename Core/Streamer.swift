@@ -11,9 +11,14 @@ private func vtOutputCallback(_ outputCallbackRefCon: UnsafeMutableRawPointer?,
                               _ status: OSStatus,
                               _ infoFlags: VTEncodeInfoFlags,
                               _ sampleBuffer: CMSampleBuffer?) {
-    guard status == noErr, let sbuf = sampleBuffer, let refCon = outputCallbackRefCon else { return }
+    guard let refCon = outputCallbackRefCon else { return }
     let streamer = Unmanaged<Streamer>.fromOpaque(refCon).takeUnretainedValue()
-    streamer.handleEncodedSampleBuffer(sbuf)
+    let frameId = UInt64(UInt(bitPattern: sourceFrameRefCon)) &- 1 // id profiler + 1 (nil = 0)
+    guard status == noErr, !infoFlags.contains(.frameDropped), let sbuf = sampleBuffer else {
+        streamer.handleEncodeFailure(frameId: frameId)
+        return
+    }
+    streamer.handleEncodedSampleBuffer(sbuf, frameId: frameId)
 }
 
 final class Streamer: NSObject, ObservableObject, AVCaptureVideoDataOutputSampleBufferDelegate {
@@ -23,6 +28,9 @@ final class Streamer: NSObject, ObservableObject, AVCaptureVideoDataOutputSample
     @Published var isRunning: Bool = false
     @Published var isBusy: Bool = false
     @Published var metrics: String = ""
+    @Published var profiling: String = ""
+    @Published var isRecording: Bool = false
+    private var receiverLatency: String? // dernier latencyReport du lecteur (main)
 
     // MARK: Queues
     private let controlQ = DispatchQueue(label: "Streamer.control")
@@ -32,39 +40,109 @@ final class Streamer: NSObject, ObservableObject, AVCaptureVideoDataOutputSample
     private let session = AVCaptureSession()
     private var device: AVCaptureDevice?
     private let videoOutput = AVCaptureVideoDataOutput()
+    private var capturePixelFormat: OSType = kCVPixelFormatType_420YpCbCr8BiPlanarFullRange // sessionQ
+    private let formats = FormatSelector()      // scan des formats en cache entre les restarts
+    private var captureFormatInfo = ""          // format retenu (sessionQ)
 
     // MARK: Encoder
     private var vtSession: VTCompressionSession?
+    private let paramSets = NALPacker.ParameterSetCache() // SPS/PPS pré-framés (thread VT)
+    private var rtpPacketizer = RTPPacketizer()
+    private var rtpFEC = RTPFECEncoder(mediaSSRC: 0)
+    private let rtxHistory = RTPRetransmitHistory()
+    // Entrée attendue par la session VT : un buffer capture conforme passe sans conversion (sessionQ)
+    private var encoderInput: (format: OSType, width: Int, height: Int)?
+    // Pré-chauffage (sessionQ) : session de secours prête pour le mode précédent/opposé
+    private var activeShape: EncoderShape?
+    private var previousShape: EncoderShape?
+    private var warmEncoder: PreparedEncoder?
+    private var warmingShape: EncoderShape?
+    private let warmQ = DispatchQueue(label: "Streamer.warm", qos: .utility)
 
     // MARK: Réseau
-    private var listener: NWListener?
-    private var connection: NWConnection?
+    private var listener: NWListener?             // controlQ ; en veille dès le lancement (annonce Bonjour)
+    private var listenerShape: ListenerShape?     // réglages avec lesquels il a été créé
+    // Lecteurs simultanés : encodage unique, une file d'envoi par lecteur
+    private let clientsLock = NSLock()
+    private var clients: [StreamClient] = []
+    private var nextClientId = 0
+    private let maxClients = 4
+    // UDP : un lecteur parti (pare-feu muet, redémarrage sur un autre port) ne produit ni
+    // .failed ni .cancelled ; il est retiré après `udpTimeoutNs` sans datagramme, et cède
+    // sa place à un nouveau lecteur dès `udpEvictAfterNs` si la table est pleine
+    private let udpTimeoutNs: UInt64 = 5_000_000_000
+    private let udpEvictAfterNs: UInt64 = 2_000_000_000
+    private let fanOut = FrameFanOut()
 
     // MARK: Réglages (courants)
     @Published var listenPort: UInt16 = 5000
     @Published var targetWidth: Int = 1920
     @Published var targetHeight: Int = 1080
     @Published var targetFPS: Double = 120
-    @Published var intraOnly: Bool = true
+    @Published var gopMode: GOPMode = .allIntra
+    @Published var refreshInterval: Double = 2
+    @Published var codec: VideoCodec = .h264
     @Published var bitrate: Int = 60_000_000
     @Published var outputProtocol: OutputProtocol = .annexb
+    @Published var link: LinkMode = .any
+    @Published var lowLatencyTransport: Bool = false
     @Published var orientation: AVCaptureVideoOrientation = .portrait
     @Published var autoRotate: Bool = false
     @Published var profile: H264Profile = .baseline
     @Published var entropy: H264Entropy = .cavlc
+    @Published var sendQueueDepth: Int = 2
+    @Published var fecGroupSize: Int = 0
+    @Published var nackDeadlineMs: Double = 16
+    @Published var lowLatency: Bool = false
+    @Published var slicesPerFrame: Int = 4
+    @Published var adaptiveBitrate: Bool = false
+    @Published var minBitrate: Int = 10_000_000
+    @Published var latencyTags: Bool = false
+    @Published var prewarmEncoder: Bool = false
+    @Published var thermalGovernor: Bool = false
+    @Published var startOnConnect: Bool = false
 
     // MARK: Anti-dérive / sécurité
-    fileprivate var sentCodecHeader = false
-    fileprivate var forceIDRNext = false
-    private var sendingFrame = false
-    private var sessionGen: UInt64 = 0
+    private let hot = HotPathState()          // IDR demandé, génération, seq, fenêtre de stats
+    private var sentCodecHeader = false       // thread VT uniquement (remis à zéro avant la session VT)
+    private var sendDepth = 2                 // file d'envoi appliquée à chaque lecteur
+    private var sendBudget = 1 << 20
+    private let latency = LatencyTracker()
+    private let profiler = FrameProfiler()
+    private let recorder = StreamRecorder()
+
+    // Débit adaptatif : `bitrate` = plafond choisi, `rateController.current` = débit encodeur.
+    // TCP seulement : en RTP la complétion d'envoi n'est que la copie locale (pas de signal)
+    private let rateController = BitrateController(floor: 10_000_000, ceiling: 60_000_000)
+    private var adaptiveActive: Bool { adaptiveBitrate && !outputProtocol.usesUDP }
+    private var activeBitrate: Int { adaptiveActive ? rateController.current : bitrate }
+
+    // Sortie réseau de la session VT active, relevée sur sessionQ (activation, réglages à
+    // chaud) et lue par le thread VT / les queues réseau. `apply()` change les @Published
+    // aussitôt ; les frames de l'ancienne session gardent ainsi protocole et options.
+    private struct OutputSettings {
+        var proto: OutputProtocol = .annexb
+        var latencyTags = false
+        var fecGroupSize = 0
+        var nackDeadlineMs: Double = 0
+        var adaptive = false
+    }
+    private let outputLock = NSLock()
+    private var outputState = OutputSettings()
+    private var output: OutputSettings {
+        outputLock.lock(); defer { outputLock.unlock() }
+        return outputState
+    }
 
     // Stats
     private var statsTimer: DispatchSourceTimer?
-    private var bytesWindow: Int = 0
-    private var framesWindow: Int = 0
 
-    // State
+    // Gouverneur thermique : évalué par les stats (main), palier appliqué sur controlQ
+    private let governor = QualityGovernor()
+    private var governorLevel = 0                 // controlQ
+    private var requestedConfig: PendingConfig?   // controlQ : réglages choisis dans l'UI
+
+    // State (controlQ uniquement)
     private enum State { case idle, starting, running, stopping }
     private var state: State = .idle
 
@@ -80,56 +158,142 @@ final class Streamer: NSObject, ObservableObject, AVCaptureVideoDataOutputSample
         targetHeight = p.resolution.height
         targetFPS    = p.fps
         bitrate      = Int(p.bitrate)
-        intraOnly    = p.intraOnly
+        gopMode      = p.gopMode
+        refreshInterval = p.refreshInterval
+        codec        = p.codec
         outputProtocol = p.outputProtocol
+        link         = p.link
+        lowLatencyTransport = p.lowLatencyTransport
         orientation  = p.orientation
         autoRotate   = p.autoRotate
         profile      = p.profile
         entropy      = p.entropy
+        sendQueueDepth = p.sendQueueDepth
+        fecGroupSize = p.fecGroupSize
+        nackDeadlineMs = p.nackDeadlineMs
+        lowLatency = p.lowLatency
+        slicesPerFrame = p.slicesPerFrame
+        adaptiveBitrate = p.adaptiveBitrate
+        minBitrate   = Int(p.minBitrate)
+        latencyTags  = p.latencyTags
+        prewarmEncoder = p.prewarmEncoder
+        thermalGovernor = p.thermalGovernor
+        startOnConnect = p.startOnConnect
+        rateController.setRange(floor: minBitrate, ceiling: bitrate) // débit ABR atteint conservé
     }
 
-    /// Applique `pending` : live si possible, sinon restart propre.
-    func applyOrRestart(with new: PendingConfig) {
+    /// Applique `pending` : live si possible, sinon reconfiguration rapide, sinon restart complet.
+    /// Les réglages demandés sont conservés ; le gouverneur thermique applique sa dégradation par-dessus.
+    func applyOrRestart(with requested: PendingConfig) {
         controlQ.async {
-            // Détecte si un rebuild est requis (change le "bitstream shape")
-            let needsRestart =
-                new.resolution.width  != self.targetWidth  ||
-                new.resolution.height != self.targetHeight ||
-                new.profile           != self.profile      ||
-                new.entropy           != self.entropy      ||
-                new.outputProtocol    != self.outputProtocol ||
-                new.port              != self.listenPort
-
-            self.setConfig(from: new)
-
-            guard self.isRunning else {
-                // pas démarré : rien d’autre à faire
-                return
-            }
+            self.requestedConfig = requested
+            if !requested.thermalGovernor { self.governorLevel = 0 }
+            self.apply(self.governed(requested))
+        }
+    }
+
+    /// Réglages effectifs : demandés, dégradés du palier courant du gouverneur (controlQ)
+    private func governed(_ c: PendingConfig) -> PendingConfig {
+        c.thermalGovernor ? QualityGovernor.degrade(c, level: governorLevel) : c
+    }
+
+    /// Nouveau palier du gouverneur : mêmes chemins que l'UI (live / reconfiguration rapide)
+    private func applyGovernorLevel(_ level: Int) {
+        controlQ.async {
+            guard self.state == .running else { return }
+            self.governorLevel = level
+            let base = self.requestedConfig ?? PendingConfig(from: self)
+            if self.requestedConfig == nil { self.requestedConfig = base }
+            self.apply(self.governed(base))
+        }
+    }
 
-            if needsRestart {
-                self.restart()
+    private func apply(_ new: PendingConfig) {
+        // Le listener change : seul cas qui impose de couper les lecteurs
+        let needsRestart =
+            new.port                   != self.listenPort ||
+            new.link                   != self.link ||
+            new.lowLatencyTransport    != self.lowLatencyTransport ||
+            new.outputProtocol.usesUDP != self.outputProtocol.usesUDP
+        // Change le "bitstream shape" : nouvelle session VT (+ format caméra)
+        let needsReconfigure =
+            new.resolution.width  != self.targetWidth  ||
+            new.resolution.height != self.targetHeight ||
+            new.codec             != self.codec        ||
+            new.profile           != self.profile      ||
+            new.entropy           != self.entropy      ||
+            new.outputProtocol    != self.outputProtocol ||
+            new.lowLatency        != self.lowLatency
+
+        self.setConfig(from: new)
+
+        guard self.state == .running else {
+            // pas démarré : seul le listener en veille suit les réglages (port, lien, TXT)
+            if self.state == .idle, self.listener != nil { self.ensureListener() }
+            if self.state == .idle { self.sessionQ.async { self.publishOutput() } } // aucune frame en vol
+            return
+        }
+
+        if needsRestart {
+            self.restart()
+        } else if needsReconfigure {
+            self.reconfigure()
+            self.updateAdvertisement()
+        } else {
+            self.applyLiveTweaks()
+            self.updateAdvertisement()
+        }
+    }
+
+    /// Reconfiguration incrémentale : listener, lecteurs et AVCaptureSession restent en place.
+    /// Le format caméra change dans begin/commitConfiguration sans retirer l'input, seule la
+    /// session VT est reconstruite ; le premier IDR porte les nouveaux parameter sets.
+    private func reconfigure() {
+        sessionQ.async {
+            let t0 = HostClock.now()
+            self.hot.beginReconfigure(at: t0)
+            if let cam = self.device {
+                self.session.beginConfiguration()
+                self.configureCaptureFormat(cam)
+                self.configureCaptureConnection(keepOrientation: self.autoRotate) // suivie par l'auto-rotate
+                self.session.commitConfiguration()
+            }
+            // Session pré-chauffée pour ce mode : bascule entre deux captures (frontière de frame)
+            let shape = self.currentShape(width: self.targetWidth, height: self.targetHeight)
+            var warm: PreparedEncoder?
+            if let w = self.warmEncoder, w.shape == shape {
+                self.warmEncoder = nil
+                warm = w
+            }
+            let leaving = self.activeShape
+            self.teardownEncoder()
+            self.activeShape = leaving // pour `previousShape` à l'activation
+            // Plus aucun callback VT en cours : l'état du thread VT se réinitialise ici
+            self.sentCodecHeader = false
+            self.paramSets.reset()
+            if self.rtpPacketizer.hevc != self.codec.isHEVC {
+                self.rtpPacketizer = RTPPacketizer(hevc: self.codec.isHEVC)
+                self.rtpFEC = RTPFECEncoder(mediaSSRC: self.rtpPacketizer.ssrc)
+                self.rtxHistory.reset()
+            }
+            self.configureSendQueue()
+            self.hot.requestIDR()
+            if let w = warm {
+                self.applyLiveProperties(w.session, self.encoderSettings()) // fps / débit / GOP ont pu changer depuis le warmup
+                self.activate(w)
             } else {
-                self.applyLiveTweaks()
+                self.setupEncoder(width: self.targetWidth, height: self.targetHeight)
             }
         }
     }
 
-    /// Modifs à chaud (bitrate, fps, GOP, orientation)
+    /// Modifs à chaud (bitrate, fps, GOP, orientation, file d'envoi)
     private func applyLiveTweaks() {
         sessionQ.async {
-            if let vt = self.vtSession {
-                VTSessionSetProperty(vt, key: kVTCompressionPropertyKey_AverageBitRate,
-                                     value: NSNumber(value: self.bitrate))
-                let limits: [NSNumber] = [NSNumber(value: self.bitrate/8), NSNumber(value: 1)]
-                VTSessionSetProperty(vt, key: kVTCompressionPropertyKey_DataRateLimits,
-                                     value: limits as CFArray)
-                VTSessionSetProperty(vt, key: kVTCompressionPropertyKey_ExpectedFrameRate,
-                                     value: NSNumber(value: Int32(self.targetFPS)))
-                let gop: Int32 = self.intraOnly ? 1 : 30
-                VTSessionSetProperty(vt, key: kVTCompressionPropertyKey_MaxKeyFrameInterval,
-                                     value: NSNumber(value: gop))
-            }
+            self.configureSendQueue()
+            self.publishOutput() // protocole inchangé ici : seules les options bougent
+            if let vt = self.vtSession { self.applyLiveProperties(vt, self.encoderSettings()) }
+            self.scheduleWarmEncoder() // pré-chauffage activé/désactivé à chaud
             if let dev = self.device {
                 do {
                     try dev.lockForConfiguration()
@@ -139,26 +303,83 @@ final class Streamer: NSObject, ObservableObject, AVCaptureVideoDataOutputSample
                     dev.unlockForConfiguration()
                 } catch { /* ignore */ }
             }
-            if let conn = self.videoOutput.connection(with: .video) {
+            if !self.autoRotate, let conn = self.videoOutput.connection(with: .video) {
                 conn.videoOrientation = self.orientation
             }
-            self.forceIDRNext = true // re-sync côté lecteur
+            self.followOrientation()
+            self.hot.requestIDR() // re-sync côté lecteur
             DispatchQueue.main.async { self.status = "Live updated (bitrate/fps/GOP/orientation)" }
         }
     }
 
+    /// Débit encodeur seul (régulation) : pas d'IDR forcé, le flux reste décodable
+    private func applyRateChange() {
+        sessionQ.async {
+            self.configureSendQueue()
+            if let vt = self.vtSession {
+                let s = self.encoderSettings()
+                self.applyBitrate(vt, s)
+                self.applySliceLimit(vt, s)
+            }
+        }
+    }
+
+    /// Début de session uniquement : en cours de route les bornes passent par setRange
+    private func resetRateControl() {
+        rateController.reset(floor: minBitrate, ceiling: bitrate)
+    }
+
     // MARK: Lifecycle
     func requestKeyframe() {
-        controlQ.async { [weak self] in self?.forceIDRNext = true }
+        hot.requestIDR() // atomique : appelable depuis n'importe quelle file
+    }
+
+    /// Archive du flux encodé dans Documents (format .framed), sans second encodeur
+    func setRecording(_ on: Bool) {
+        controlQ.async {
+            if on, !self.recorder.isRecording {
+                // Disque en retard : reprise sur un IDR demandé tout de suite, pas au prochain GOP
+                self.recorder.onKeyframeNeeded = { [weak self] in self?.hot.requestIDR() }
+                let url = self.recorder.start()
+                self.hot.requestIDR() // le fichier commence sur un IDR
+                DispatchQueue.main.async {
+                    self.isRecording = url != nil
+                    self.status = url.map { "Enregistrement : \($0.lastPathComponent)" } ?? "Enregistrement impossible"
+                }
+            } else if !on {
+                self.recorder.stop()
+                let c = self.recorder.counters
+                DispatchQueue.main.async {
+                    self.isRecording = false
+                    self.status = "Enregistrement arrêté (\(c.written) frames, \(c.dropped) jetées)"
+                }
+            }
+        }
+    }
+
+    /// Listener + annonce Bonjour dès le lancement : le lecteur se connecte avant le Start,
+    /// la poignée de main ne s'ajoute plus au démarrage caméra + encodeur
+    func advertise() {
+        controlQ.async {
+            guard self.state == .idle else { return }
+            self.ensureListener()
+        }
     }
 
     func start() {
-        guard state == .idle else { return }
-        DispatchQueue.main.async { self.isBusy = true; self.status = "Checking camera…" }
+        controlQ.async {
+            guard self.state == .idle else { return }
+            self.state = .starting // un second start() pendant l'autorisation est ignoré
+            DispatchQueue.main.async { self.isBusy = true; self.status = "Checking camera…" }
+            self.authorizeAndStart()
+        }
+    }
 
+    private func authorizeAndStart() {
         ensureCameraAuthorized { [weak self] granted in
             guard let self = self else { return }
             guard granted else {
+                self.controlQ.async { self.state = .idle }
                 DispatchQueue.main.async {
                     self.isBusy = false
                     self.status = "Accès caméra refusé (Réglages > Confidentialité > Caméra)"
@@ -167,27 +388,56 @@ final class Streamer: NSObject, ObservableObject, AVCaptureVideoDataOutputSample
             }
 
             self.controlQ.async {
-                guard self.state == .idle else { return }
-                self.state = .starting
-
-                self.sessionGen &+= 1
-                self.sentCodecHeader = false
-                self.forceIDRNext = true
-                self.sendingFrame = false
+                guard self.state == .starting else { return }
+
+                self.hot.nextGeneration()
+                self.sentCodecHeader = false // avant la session VT (sessionQ.async plus bas)
+                self.hot.requestIDR()
+                for c in self.activeClients { c.rejoin() } // connectés pendant la veille
+                self.resetRateControl()
+                self.configureSendQueue()
+                self.paramSets.reset()
+                self.rtpPacketizer = RTPPacketizer(hevc: self.codec.isHEVC)
+                self.rtpFEC = RTPFECEncoder(mediaSSRC: self.rtpPacketizer.ssrc)
+                self.rtxHistory.reset()
+                self.hot.resetFrameSeq()
+                self.latency.reset()
+                self.profiler.reset()
 
                 DispatchQueue.main.async {
                     UIApplication.shared.isIdleTimerDisabled = true
                 }
 
-                self.setupTCP(on: self.listenPort)
+                self.ensureListener()
 
                 self.sessionQ.async {
+                    // Encodeur préparé pendant le démarrage caméra (les deux dominent le temps
+                    // jusqu'à la première frame), à partir d'un relevé pris ici : la capture peut
+                    // changer fps et format pendant ce temps. Format d'entrée supposé = celui de
+                    // la session précédente ; forme et réglages sont revérifiés après la capture
+                    let guess = self.currentShape(width: self.targetWidth, height: self.targetHeight)
+                    let settings = self.encoderSettings()
+                    var early: PreparedEncoder?
+                    let prepared = DispatchGroup()
+                    DispatchQueue.global(qos: .userInitiated).async(group: prepared) {
+                        early = self.makeEncoder(guess, settings)
+                    }
                     self.setupCapture()
-                    self.setupEncoder(width: self.targetWidth, height: self.targetHeight)
+                    prepared.wait()
+                    let shape = self.currentShape(width: self.targetWidth, height: self.targetHeight)
+                    if let e = early, e.shape == shape, settings == self.encoderSettings() {
+                        self.activate(e)
+                    } else {
+                        if let e = early { VTCompressionSessionInvalidate(e.session) }
+                        self.setupEncoder(width: self.targetWidth, height: self.targetHeight)
+                    }
                     self.startStats()
+                    self.controlQ.async {
+                        self.state = .running
+                        self.updateAdvertisement()
+                    }
                     DispatchQueue.main.async {
                         self.installOrientationObserverIfNeeded()
-                        self.state = .running
                         self.isRunning = true
                         self.isBusy = false
                         self.status = "Running"
@@ -206,29 +456,36 @@ final class Streamer: NSObject, ObservableObject, AVCaptureVideoDataOutputSample
             self.sessionQ.sync {
                 self.videoOutput.setSampleBufferDelegate(nil, queue: nil)
                 self.session.stopRunning()
-                if let vt = self.vtSession {
-                    self.vtSession = nil
-                    VTCompressionSessionCompleteFrames(vt, untilPresentationTimeStamp: .invalid)
-                    VTCompressionSessionInvalidate(vt)
-                }
+                // Session vidée : le start suivant peut rajouter input et output
+                self.session.beginConfiguration()
+                self.session.inputs.forEach { self.session.removeInput($0) }
+                self.session.outputs.forEach { self.session.removeOutput($0) }
+                self.session.commitConfiguration()
+                self.teardownEncoder()
+                self.discardWarmEncoder()
+                self.previousShape = nil
             }
 
-            self.connection?.cancel(); self.connection = nil
-            self.listener?.cancel(); self.listener = nil
+            // Listener et lecteurs restent en place : annonce Bonjour, reprise au prochain start
 
             DispatchQueue.main.async {
                 UIApplication.shared.isIdleTimerDisabled = false
             }
 
             self.stopStats()
+            self.recorder.stop()
             self.removeOrientationObserver()
 
             self.state = .idle
+            self.updateAdvertisement()
             DispatchQueue.main.async {
                 self.isRunning = false
                 self.isBusy = false
                 self.status = "Arrêté"
                 self.metrics = ""
+                self.isRecording = false
+                self.receiverLatency = nil
+                self.profiling = ""
             }
         }
     }
@@ -237,8 +494,9 @@ final class Streamer: NSObject, ObservableObject, AVCaptureVideoDataOutputSample
         controlQ.async {
             switch self.state {
             case .running:
+                // stop() s'exécute en entier sur controlQ (teardown synchrone) avant ce start()
                 self.stop()
-                self.controlQ.asyncAfter(deadline: .now() + 0.3) { self.start() }
+                self.start()
             case .idle:
                 self.start()
             default:
@@ -260,34 +518,239 @@ final class Streamer: NSObject, ObservableObject, AVCaptureVideoDataOutputSample
         }
     }
 
-    // MARK: TCP
-    private func setupTCP(on port: UInt16) {
+    // MARK: Réseau (TCP, ou UDP pour RTP : le lecteur s'abonne par un premier datagramme)
+    private struct ListenerShape: Equatable {
+        let port: UInt16
+        let udp: Bool
+        let link: LinkMode
+        let fast: Bool
+    }
+
+    /// Listener conservé s'il correspond aux réglages (lecteurs gardés), recréé sinon (controlQ)
+    private func ensureListener() {
+        let shape = ListenerShape(port: listenPort, udp: outputProtocol.usesUDP,
+                                  link: link, fast: lowLatencyTransport)
+        if listener != nil, listenerShape == shape {
+            updateAdvertisement()
+            return
+        }
+        for c in removeAllClients() { c.connection.cancel() }
+        listener?.cancel(); listener = nil
+        listenerShape = nil
+        setupListener(on: listenPort)
+        if listener != nil { listenerShape = shape }
+    }
+
+    /// TXT Bonjour à jour (codec, résolution, fps, protocole, en cours ou non) ; controlQ
+    private func updateAdvertisement() {
+        listener?.service = advertisedService()
+    }
+
+    private func advertisedService() -> NWListener.Service {
+        ServiceAdvertiser.service(codec: codec, width: targetWidth, height: targetHeight, fps: targetFPS,
+                                  proto: outputProtocol, live: state == .running)
+    }
+
+    private func setupListener(on port: UInt16) {
+        let udp = outputProtocol.usesUDP
+        let proto = udp ? "UDP" : "TCP"
         do {
             guard let p = NWEndpoint.Port(rawValue: port) else {
                 DispatchQueue.main.async { self.status = "Port invalide \(port)" }
                 return
             }
-            let params = NWParameters.tcp
-            params.allowLocalEndpointReuse = true
+            let fast = lowLatencyTransport
+            let params = TransportProfile.parameters(udp: udp, lowLatency: fast, link: link)
+            let ctx = TransportProfile.datagramContext(lowLatency: udp && fast) // propre à ce listener
             let lst = try NWListener(using: params, on: p)
-            lst.stateUpdateHandler = { [weak self] st in
-                DispatchQueue.main.async { self?.status = "Listener(\(port)): \(st)" }
+            lst.service = advertisedService()
+            lst.stateUpdateHandler = { [weak self, weak lst] st in
+                guard let self = self else { return }
+                let link = self.link == .wired ? ", filaire" : ""
+                DispatchQueue.main.async { self.status = "Listener(\(port)\(link)): \(st)" }
+                if case .failed = st {
+                    // Port pris… : le prochain start / réglage recrée le listener
+                    self.controlQ.async {
+                        guard let lst = lst, self.listener === lst else { return }
+                        self.listener = nil
+                        self.listenerShape = nil
+                    }
+                }
             }
             lst.newConnectionHandler = { [weak self] conn in
                 guard let self = self else { return }
-                self.connection?.cancel()
-                self.connection = conn
-                self.sentCodecHeader = false
-                self.forceIDRNext = true
-                conn.stateUpdateHandler = { st in
-                    DispatchQueue.main.async { self.status = "TCP client: \(st)" }
+                // Le nouveau lecteur s'ajoute aux autres ; au-delà de maxClients il est refusé
+                // (sauf lecteur UDP muet à remplacer)
+                let (added, evicted) = self.addClient(conn, context: ctx, udp: udp)
+                if let old = evicted {
+                    old.connection.cancel()
+                    DispatchQueue.main.async { self.status = "UDP client #\(old.id) silencieux remplacé" }
+                }
+                guard let client = added else {
+                    conn.cancel()
+                    return
+                }
+                conn.stateUpdateHandler = { [weak self] st in
+                    guard let self = self else { return }
+                    var via = ""
+                    switch st {
+                    case .ready:
+                        self.sendCachedParameterSets(to: client)
+                        via = Self.interfaceLabel(conn.currentPath)
+                            + TransportProfile.describe(conn, udp: udp, lowLatency: fast)
+                    case .failed, .cancelled:
+                        self.removeClient(client.id)
+                    default: break
+                    }
+                    let n = self.clientCount
+                    DispatchQueue.main.async { self.status = "\(proto) client #\(client.id): \(st)\(via) • \(n) lecteur(s)" }
                 }
                 conn.start(queue: .global(qos: .userInitiated))
+                self.requestKeyframe() // entrée en cours de flux : IDR à la demande
+                // Caméra + encodeur démarrent pendant la poignée de main (sans effet si déjà lancé)
+                if self.startOnConnect { self.start() }
+                if udp {
+                    self.receiveFeedback(from: client)
+                } else {
+                    let id = client.id
+                    ControlChannel.receiveStream(on: conn) { [weak self] m in self?.handleControl(m, from: id) }
+                }
             }
             lst.start(queue: .global(qos: .userInitiated))
             self.listener = lst
         } catch {
-            DispatchQueue.main.async { self.status = "TCP error: \(error.localizedDescription)" }
+            DispatchQueue.main.async { self.status = "\(proto) error: \(error.localizedDescription)" }
+        }
+    }
+
+    /// Lien effectif d'un lecteur : « loopback » = tunnel usbmuxd, « filaire » = Ethernet USB
+    private static func interfaceLabel(_ path: NWPath?) -> String {
+        guard let path = path else { return "" }
+        if path.usesInterfaceType(.loopback) { return " via USB (usbmuxd)" }
+        if path.usesInterfaceType(.wiredEthernet) { return " via filaire" }
+        if path.usesInterfaceType(.wifi) { return " via Wi-Fi" }
+        return ""
+    }
+
+    /// Table pleine : le lecteur UDP muet depuis le plus longtemps est évincé (à annuler
+    /// par l'appelant, hors verrou), sinon le nouveau est refusé
+    private func addClient(_ conn: NWConnection, context: NWConnection.ContentContext,
+                           udp: Bool) -> (added: StreamClient?, evicted: StreamClient?) {
+        clientsLock.lock(); defer { clientsLock.unlock() }
+        var evicted: StreamClient?
+        if clients.count >= maxClients {
+            let now = HostClock.now()
+            let silent = clients.filter { $0.udp && $0.silence(at: now) > udpEvictAfterNs }
+            guard let oldest = silent.max(by: { $0.silence(at: now) < $1.silence(at: now) }) else {
+                return (nil, nil)
+            }
+            clients.removeAll { $0 === oldest }
+            evicted = oldest
+        }
+        nextClientId += 1
+        let c = StreamClient(id: nextClientId, connection: conn, context: context, udp: udp,
+                             depth: sendDepth, byteBudget: sendBudget)
+        clients.append(c)
+        return (c, evicted)
+    }
+
+    /// Lecteurs UDP sans datagramme depuis `udpTimeoutNs` : retirés et annulés (stats)
+    private func expireSilentClients() -> [StreamClient] {
+        let now = HostClock.now()
+        clientsLock.lock()
+        let stale = clients.filter { $0.udp && $0.silence(at: now) > udpTimeoutNs }
+        clients.removeAll { c in stale.contains { $0 === c } }
+        clientsLock.unlock()
+        for c in stale { c.connection.cancel() }
+        return stale
+    }
+
+    private func removeClient(_ id: Int) {
+        clientsLock.lock(); defer { clientsLock.unlock() }
+        clients.removeAll { $0.id == id }
+    }
+
+    private func removeAllClients() -> [StreamClient] {
+        clientsLock.lock(); defer { clientsLock.unlock() }
+        let all = clients
+        clients = []
+        return all
+    }
+
+    private var activeClients: [StreamClient] {
+        clientsLock.lock(); defer { clientsLock.unlock() }
+        return clients
+    }
+
+    private var clientCount: Int { activeClients.count }
+
+    /// SPS/PPS en cache envoyés dès la connexion (flux TCP) : le lecteur prépare son
+    /// décodeur en attendant l'IDR. En RTP l'IDR demandé les embarque déjà.
+    private func sendCachedParameterSets(to client: StreamClient) {
+        let proto = output.proto
+        guard !proto.usesUDP, var config = paramSets.framed(for: proto) else { return }
+        if proto == .framed {
+            // Pas une frame du flux : ne consomme pas de seq (sinon doublon avec la frame suivante)
+            var framed = FrameHeader.make(hevc: paramSets.isHEVC, flags: [.config, .outOfSequence], seq: 0,
+                                          ptsNs: HostClock.now(), length: config.count)
+            framed.append(config)
+            config = framed
+        }
+        Self.send(config, on: client.connection, context: .defaultMessage, completion: .idempotent)
+    }
+
+    /// Retour UDP du lecteur : messages de contrôle, ou RTCP Generic NACK →
+    /// retransmission si encore dans la deadline. Tout datagramme vaut signe de vie.
+    private func receiveFeedback(from client: StreamClient) {
+        client.connection.receiveMessage { [weak self, weak client] data, _, _, error in
+            guard let self = self, let client = client, error == nil else { return }
+            let conn = client.connection
+            let context = client.context
+            if data != nil { client.markHeard(at: HostClock.now()) }
+            if let data = data, ControlMessage.isControl(data) {
+                if let m = ControlMessage.parse(data) { self.handleControl(m, from: client.id) }
+            } else if let data = data, !data.isEmpty {
+                let now = HostClock.now()
+                let lost = RTPRetransmitHistory.parseNACK(data)
+                if !lost.isEmpty {
+                    conn.batch {
+                        for seq in lost {
+                            guard let pkt = self.rtxHistory.lookup(seq, now: now) else { continue }
+                            Self.send(pkt, on: conn, context: context, completion: .idempotent)
+                        }
+                    }
+                }
+            }
+            self.receiveFeedback(from: client)
+        }
+    }
+
+    /// Commandes du lecteur `client` : mêmes chemins que l'UI (demande d'IDR / réglages à chaud)
+    private func handleControl(_ m: ControlMessage, from client: Int) {
+        switch m {
+        case .clockPing(let t0):
+            latency.clockPing(client: client, t0: t0, receivedAt: HostClock.now())
+        case .requestIDR, .invalidateRefs:
+            // Pas d'invalidation de références publique dans VT : l'IDR est la resynchro sûre
+            requestKeyframe()
+        case .setBitrate(let bps):
+            controlQ.async {
+                self.bitrate = min(max(bps, 1_000_000), 200_000_000)
+                self.rateController.setRange(floor: self.minBitrate, ceiling: self.bitrate)
+                self.applyRateChange()
+            }
+        case .setFPS(let fps):
+            controlQ.async {
+                let maxF = self.maxSupportedFPS(width: self.targetWidth, height: self.targetHeight)
+                self.targetFPS = min(max(fps, 1), maxF)
+                self.applyLiveTweaks()
+            }
+        case .latencyReport(let p50, let p95, let p99):
+            DispatchQueue.main.async {
+                self.receiverLatency = String(format: "rx %.1f/%.1f/%.1f ms", p50, p95, p99)
+            }
+        case .keepalive:
+            break // signe de vie déjà noté à la réception (UDP)
         }
     }
 
@@ -317,16 +780,8 @@ final class Streamer: NSObject, ObservableObject, AVCaptureVideoDataOutputSample
             return
         }
 
-        let maxF = maxSupportedFPS(width: targetWidth, height: targetHeight)
-        if targetFPS > maxF { targetFPS = maxF }
-        if !selectFormat(device: cam, width: targetWidth, height: targetHeight, fps: targetFPS) {
-            _ = selectFormat(device: cam, width: targetWidth, height: targetHeight, fps: min(60.0, maxF))
-        }
-
         videoOutput.alwaysDiscardsLateVideoFrames = true
-        videoOutput.videoSettings = [
-            kCVPixelBufferPixelFormatTypeKey as String: kCVPixelFormatType_420YpCbCr8BiPlanarFullRange
-        ]
+        configureCaptureFormat(cam)
         videoOutput.setSampleBufferDelegate(self, queue: sessionQ)
         guard session.canAddOutput(videoOutput) else {
             DispatchQueue.main.async { self.status = "Output refusé" }
@@ -334,34 +789,71 @@ final class Streamer: NSObject, ObservableObject, AVCaptureVideoDataOutputSample
             return
         }
         session.addOutput(videoOutput)
-
-        if let c = videoOutput.connection(with: .video) { c.videoOrientation = orientation }
+        configureCaptureConnection()
 
         session.commitConfiguration()
         session.startRunning()
+        let info = captureFormatInfo
         DispatchQueue.main.async {
-            self.status = "Capture OK (\(self.targetWidth)x\(self.targetHeight) @\(Int(self.targetFPS)) fps tentative)"
+            self.status = "Capture OK (\(self.targetWidth)x\(self.targetHeight) @\(Int(self.targetFPS)) fps tentative, \(info))"
         }
     }
 
-    private func selectFormat(device: AVCaptureDevice, width: Int, height: Int, fps: Double) -> Bool {
-        var chosen: AVCaptureDevice.Format?
-        for f in device.formats {
-            let dims = CMVideoFormatDescriptionGetDimensions(f.formatDescription)
-            guard dims.width == width && dims.height == height else { continue }
-            if f.videoSupportedFrameRateRanges.contains(where: { $0.maxFrameRate + 0.001 >= fps }) {
-                chosen = f; break
-            }
+    /// Format caméra + format des buffers (dans un begin/commitConfiguration)
+    private func configureCaptureFormat(_ cam: AVCaptureDevice) {
+        let maxF = maxSupportedFPS(width: targetWidth, height: targetHeight)
+        if targetFPS > maxF { targetFPS = maxF }
+        if !selectFormat(device: cam, width: targetWidth, height: targetHeight, fps: targetFPS) {
+            _ = selectFormat(device: cam, width: targetWidth, height: targetHeight, fps: min(60.0, maxF))
         }
-        guard let fmt = chosen else { return false }
+        // Buffers capture toujours IOSurface ; seul le format (et sa plage) est à aligner
+        capturePixelFormat = nativePixelFormat(for: cam)
+        videoOutput.videoSettings = [
+            kCVPixelBufferPixelFormatTypeKey as String: capturePixelFormat
+        ]
+    }
+
+    private func configureCaptureConnection(keepOrientation: Bool = false) {
+        guard let c = videoOutput.connection(with: .video) else { return }
+        if !keepOrientation { c.videoOrientation = orientation }
+        // Stabilisation = plusieurs frames de retard : toujours coupée
+        if c.isVideoStabilizationSupported { c.preferredVideoStabilizationMode = .off }
+    }
+
+    /// Format natif du capteur (420v ou 420f, x420 en 10-bit) : ni conversion côté capture,
+    /// ni côté VT puisque la session est créée avec le même format
+    private func nativePixelFormat(for cam: AVCaptureDevice) -> OSType {
+        let available = videoOutput.availableVideoPixelFormatTypes
+        let native = CMFormatDescriptionGetMediaSubType(cam.activeFormat.formatDescription)
+        let tenBit: Set<OSType> = [kCVPixelFormatType_420YpCbCr10BiPlanarVideoRange,
+                                   kCVPixelFormatType_420YpCbCr10BiPlanarFullRange]
+        let eightBit: Set<OSType> = [kCVPixelFormatType_420YpCbCr8BiPlanarVideoRange,
+                                     kCVPixelFormatType_420YpCbCr8BiPlanarFullRange]
+        let wanted = codec == .hevc10 ? tenBit : eightBit
+        if wanted.contains(native) && available.contains(native) { return native }
+        // 10-bit seulement si le format caméra le fournit, sinon 8-bit (VT convertit)
+        if available.contains(codec.pixelFormat) { return codec.pixelFormat }
+        return kCVPixelFormatType_420YpCbCr8BiPlanarFullRange
+    }
+
+    private func selectFormat(device: AVCaptureDevice, width: Int, height: Int, fps: Double) -> Bool {
+        // HEVC 10-bit : on préfère un format capteur 10-bit natif (score)
+        guard let choice = formats.best(device, width: width, height: height, fps: fps,
+                                        tenBit: codec == .hevc10) else { return false }
+        let fmt = choice.scanned.format
         do {
             try device.lockForConfiguration()
             let ts = CMTime(value: 1, timescale: CMTimeScale(fps))
             device.activeFormat = fmt
             device.activeVideoMinFrameDuration = ts
             device.activeVideoMaxFrameDuration = ts
+            if fmt.isVideoHDRSupported {
+                device.automaticallyAdjustsVideoHDREnabled = false
+                device.isVideoHDREnabled = false
+            }
             device.unlockForConfiguration()
-            DispatchQueue.main.async { self.status = "Format fixé: \(width)x\(Int(height)) @\(Int(fps))" }
+            captureFormatInfo = choice.summary
+            DispatchQueue.main.async { self.status = "Format fixé: \(width)x\(Int(height)) @\(Int(fps)) (\(choice.summary))" }
             return true
         } catch {
             DispatchQueue.main.async { self.status = "Format err: \(error.localizedDescription)" }
@@ -369,104 +861,362 @@ final class Streamer: NSObject, ObservableObject, AVCaptureVideoDataOutputSample
         }
     }
 
-    /// FPS max pour une résolution donnée
+    /// FPS max pour une résolution donnée (scan en cache)
     func maxSupportedFPS(width: Int, height: Int) -> Double {
         let dev = device ?? AVCaptureDevice.default(.builtInWideAngleCamera, for: .video, position: .back)
         guard let d = dev else { return 60 }
-        var maxF: Double = 30
-        for f in d.formats {
-            let dims = CMVideoFormatDescriptionGetDimensions(f.formatDescription)
-            guard dims.width == width && dims.height == height else { continue }
-            for r in f.videoSupportedFrameRateRanges { maxF = max(maxF, r.maxFrameRate) }
-        }
-        return maxF
+        return max(30, formats.maxFPS(d, width: width, height: height))
     }
 
     // MARK: Encoder
+    /// Paramètres qui imposent une nouvelle session VT (le reste se règle à chaud)
+    private struct EncoderShape: Equatable {
+        var width: Int
+        var height: Int
+        var codec: VideoCodec
+        var profile: H264Profile
+        var entropy: H264Entropy
+        var lowLatency: Bool
+        var pixelFormat: OSType
+    }
+
+    /// Session VT créée et préparée, prête à recevoir des frames
+    private struct PreparedEncoder {
+        let shape: EncoderShape
+        let session: VTCompressionSession
+        let input: (format: OSType, width: Int, height: Int)
+        let summary: String
+    }
+
+    private func currentShape(width: Int, height: Int) -> EncoderShape {
+        let size = deliveredSize(width: width, height: height)
+        return EncoderShape(width: size.width, height: size.height, codec: codec, profile: profile,
+                            entropy: entropy, lowLatency: lowLatency, pixelFormat: capturePixelFormat)
+    }
+
+    /// Dimensions des buffers livrés : en portrait la connexion capture les tourne
+    /// physiquement (1080x1920), la session VT doit avoir les mêmes pour éviter une conversion
+    private func deliveredSize(width: Int, height: Int) -> (width: Int, height: Int) {
+        let ori = videoOutput.connection(with: .video)?.videoOrientation ?? orientation
+        let long = max(width, height), short = min(width, height)
+        return ori == .portrait || ori == .portraitUpsideDown ? (short, long) : (long, short)
+    }
+
+    /// Bascule portrait ↔ paysage : les buffers changent de dimensions, nouvelle session VT
+    /// par le chemin de reconfiguration (IDR avec les nouveaux parameter sets)
+    private func followOrientation() {
+        guard let cur = activeShape else { return }
+        let size = deliveredSize(width: targetWidth, height: targetHeight)
+        guard size.width != cur.width || size.height != cur.height else { return }
+        reconfigure()
+    }
+
     private func setupEncoder(width: Int, height: Int) {
+        guard let e = makeEncoder(currentShape(width: width, height: height), encoderSettings()) else { return }
+        activate(e)
+    }
+
+    /// Réglages à chaud relevés sur sessionQ : une session préparée sur une autre file les
+    /// reçoit par valeur, sans lire les propriétés du Streamer pendant qu'elles changent
+    private struct EncoderSettings: Equatable {
+        let fps: Double
+        let bitrate: Int
+        let gopMode: GOPMode
+        let refreshInterval: Double
+        let lowLatency: Bool
+        let hevc: Bool
+        let slicesPerFrame: Int
+        let udp: Bool
+        let maxPayload: Int
+    }
+
+    private func encoderSettings() -> EncoderSettings {
+        EncoderSettings(fps: targetFPS, bitrate: activeBitrate, gopMode: gopMode, refreshInterval: refreshInterval,
+                        lowLatency: lowLatency, hevc: codec.isHEVC, slicesPerFrame: slicesPerFrame,
+                        udp: outputProtocol.usesUDP, maxPayload: rtpPacketizer.maxPayload)
+    }
+
+    /// Relevé de la sortie réseau (sessionQ) : à l'activation d'une session, quand l'ancienne
+    /// est vidée, et pour les réglages à chaud qui ne changent pas le bitstream
+    private func publishOutput() {
+        let s = OutputSettings(proto: outputProtocol, latencyTags: latencyTags, fecGroupSize: fecGroupSize,
+                               nackDeadlineMs: nackDeadlineMs, adaptive: adaptiveActive)
+        outputLock.lock(); defer { outputLock.unlock() }
+        outputState = s
+    }
+
+    /// Crée + prépare une session (PrepareToEncodeFrames : pas de démarrage à froid à la première frame).
+    /// Appelable hors sessionQ pour le pré-chauffage : ne lit que `shape` et `settings`.
+    private func makeEncoder(_ shape: EncoderShape, _ settings: EncoderSettings) -> PreparedEncoder? {
         let refcon = UnsafeMutableRawPointer(Unmanaged.passUnretained(self).toOpaque())
-        let rc = VTCompressionSessionCreate(allocator: nil, width: Int32(width), height: Int32(height),
-                                            codecType: kCMVideoCodecType_H264, encoderSpecification: nil,
-                                            imageBufferAttributes: nil, compressedDataAllocator: nil,
-                                            outputCallback: vtOutputCallback, refcon: refcon, compressionSessionOut: &vtSession)
-        guard rc == noErr, let vt = vtSession else {
+        var spec: CFDictionary?
+        if shape.lowLatency, !shape.codec.isHEVC, #available(iOS 14.5, *) { // RC faible latence : H.264 uniquement
+            spec = [kVTVideoEncoderSpecification_EnableLowLatencyRateControl: kCFBooleanTrue] as CFDictionary
+        }
+        // Mêmes attributs que la capture : VT peut encoder directement l'IOSurface reçue
+        let imageAttrs: [String: Any] = [
+            kCVPixelBufferPixelFormatTypeKey as String: shape.pixelFormat,
+            kCVPixelBufferWidthKey as String: shape.width,
+            kCVPixelBufferHeightKey as String: shape.height,
+            kCVPixelBufferIOSurfacePropertiesKey as String: [String: Any]()
+        ]
+        var out: VTCompressionSession?
+        let rc = VTCompressionSessionCreate(allocator: nil, width: Int32(shape.width), height: Int32(shape.height),
+                                            codecType: shape.codec.codecType, encoderSpecification: spec,
+                                            imageBufferAttributes: imageAttrs as CFDictionary, compressedDataAllocator: nil,
+                                            outputCallback: vtOutputCallback, refcon: refcon, compressionSessionOut: &out)
+        guard rc == noErr, let vt = out else {
             DispatchQueue.main.async { self.status = "VTCompressionSessionCreate failed \(rc)" }
-            return
+            return nil
         }
 
-        // Profil
+        // Profil (HEVC : Main / Main10, pas de choix d'entropie — CABAC imposé)
         let profileCF: CFString = {
-            switch profile {
-            case .baseline: return kVTProfileLevel_H264_Baseline_AutoLevel
-            case .main:     return kVTProfileLevel_H264_Main_AutoLevel
-            case .high:     return kVTProfileLevel_H264_High_AutoLevel
+            switch (shape.codec, shape.profile) {
+            case (.hevc, _):          return kVTProfileLevel_HEVC_Main_AutoLevel
+            case (.hevc10, _):        return kVTProfileLevel_HEVC_Main10_AutoLevel
+            case (.h264, .baseline):  return kVTProfileLevel_H264_Baseline_AutoLevel
+            case (.h264, .main):      return kVTProfileLevel_H264_Main_AutoLevel
+            case (.h264, .high):      return kVTProfileLevel_H264_High_AutoLevel
             }
         }()
         VTSessionSetProperty(vt, key: kVTCompressionPropertyKey_ProfileLevel, value: profileCF)
 
         // Entropy (Baseline => CAVLC)
-        let useCabac = (profile != .baseline) && (entropy == .cabac)
-        let entropyCF: CFString = useCabac ? kVTH264EntropyMode_CABAC : kVTH264EntropyMode_CAVLC
-        VTSessionSetProperty(vt, key: kVTCompressionPropertyKey_H264EntropyMode, value: entropyCF)
+        let useCabac = shape.codec.isHEVC || ((shape.profile != .baseline) && (shape.entropy == .cabac))
+        if !shape.codec.isHEVC {
+            let entropyCF: CFString = useCabac ? kVTH264EntropyMode_CABAC : kVTH264EntropyMode_CAVLC
+            VTSessionSetProperty(vt, key: kVTCompressionPropertyKey_H264EntropyMode, value: entropyCF)
+        }
 
         // Temps réel + pas de B
         VTSessionSetProperty(vt, key: kVTCompressionPropertyKey_RealTime,             value: kCFBooleanTrue)
         VTSessionSetProperty(vt, key: kVTCompressionPropertyKey_AllowFrameReordering, value: kCFBooleanFalse)
 
-        let gop: Int32 = intraOnly ? 1 : 30
-        VTSessionSetProperty(vt, key: kVTCompressionPropertyKey_MaxKeyFrameInterval,  value: NSNumber(value: gop))
-        VTSessionSetProperty(vt, key: kVTCompressionPropertyKey_ExpectedFrameRate,    value: NSNumber(value: Int32(targetFPS)))
-        VTSessionSetProperty(vt, key: kVTCompressionPropertyKey_AverageBitRate,       value: NSNumber(value: bitrate))
-        let limits: [NSNumber] = [NSNumber(value: bitrate/8), NSNumber(value: 1)]
-        VTSessionSetProperty(vt, key: kVTCompressionPropertyKey_DataRateLimits,       value: limits as CFArray)
+        // Low-latency : aucune frame retenue dans l'encodeur + découpage en slices
+        if shape.lowLatency {
+            VTSessionSetProperty(vt, key: kVTCompressionPropertyKey_MaxFrameDelayCount, value: NSNumber(value: 0))
+        }
+        applyLiveProperties(vt, settings)
 
         VTCompressionSessionPrepareToEncodeFrames(vt)
+        let pool = inspectEncoderPool(vt, format: shape.pixelFormat, width: shape.width, height: shape.height)
+        let desc = shape.codec.isHEVC ? shape.codec.label : "\(shape.profile.label) \(useCabac ? "CABAC" : "CAVLC")"
+        return PreparedEncoder(shape: shape, session: vt, input: pool.input, summary: "\(desc), \(pool.summary)")
+    }
+
+    /// Réglages modifiables à chaud : à la création, et de nouveau à l'activation d'une session pré-chauffée
+    private func applyLiveProperties(_ vt: VTCompressionSession, _ s: EncoderSettings) {
+        applyGOP(vt, s)
+        VTSessionSetProperty(vt, key: kVTCompressionPropertyKey_ExpectedFrameRate, value: NSNumber(value: Int32(s.fps)))
+        applyBitrate(vt, s)
+        applySliceLimit(vt, s)
+    }
+
+    /// Session active (sessionQ) : la prochaine frame capturée lui est soumise
+    private func activate(_ e: PreparedEncoder) {
+        if let cur = activeShape, cur != e.shape { previousShape = cur }
+        publishOutput() // avant la première frame soumise à cette session
+        vtSession = e.session
+        encoderInput = e.input
+        activeShape = e.shape
         DispatchQueue.main.async {
-            self.statusUpdate("Encoder prêt (\(self.profile.label) \(useCabac ? "CABAC" : "CAVLC"), \(self.bitrate/1_000_000) Mb/s, GOP \(gop))")
+            self.statusUpdate("Encoder prêt (\(e.summary), \(self.activeBitrate/1_000_000) Mb/s, \(self.gopMode.label))")
+        }
+        scheduleWarmEncoder()
+    }
+
+    // MARK: Encodeur pré-chauffé (bascule instantanée entre deux modes)
+
+    /// Mode à pré-chauffer : celui qu'on vient de quitter (aller-retour 720p/4K), sinon
+    /// la résolution opposée (4K ↔ 720p) si la caméra la propose
+    private func warmTarget() -> EncoderShape? {
+        guard let cur = activeShape else { return nil }
+        if let prev = previousShape, prev != cur { return prev }
+        let alt: Resolution = max(cur.width, cur.height) >= Resolution.r4k.width ? .r720p : .r4k
+        guard let cam = device, !formats.scan(cam, width: alt.width, height: alt.height).isEmpty else { return nil }
+        let size = deliveredSize(width: alt.width, height: alt.height)
+        var s = cur
+        s.width = size.width
+        s.height = size.height
+        return s
+    }
+
+    /// Prépare la session de secours hors sessionQ (création + warmup = le gros du coût)
+    private func scheduleWarmEncoder() {
+        guard prewarmEncoder, let target = warmTarget() else {
+            discardWarmEncoder()
+            return
+        }
+        if warmEncoder?.shape == target || warmingShape == target { return }
+        discardWarmEncoder()
+        warmingShape = target
+        let settings = encoderSettings()
+        warmQ.async {
+            let e = self.makeEncoder(target, settings)
+            self.sessionQ.async {
+                guard let e = e else { return }
+                guard self.warmingShape == target, self.vtSession != nil, self.prewarmEncoder else {
+                    VTCompressionSessionInvalidate(e.session)
+                    return
+                }
+                self.warmingShape = nil
+                self.warmEncoder = e
+            }
         }
     }
 
+    private func discardWarmEncoder() {
+        warmingShape = nil
+        guard let w = warmEncoder else { return }
+        warmEncoder = nil
+        VTCompressionSessionInvalidate(w.session)
+    }
+
+    /// Attributs réels du pool VT (format préféré, pool partagé avec le client) ;
+    /// `input` sert de référence au compteur de hand-off sans conversion
+    private func inspectEncoderPool(_ vt: VTCompressionSession, format want: OSType, width: Int, height: Int)
+        -> (input: (format: OSType, width: Int, height: Int), summary: String) {
+        var shared: CFTypeRef?
+        VTSessionCopyProperty(vt, key: kVTCompressionPropertyKey_PixelBufferPoolIsShared,
+                              allocator: nil, valueOut: &shared)
+        let isShared = (shared as? Bool) ?? false
+
+        // Référence = attributs réels du pool (format et dimensions), pas ceux demandés
+        var format = want
+        var w = width, h = height
+        if let pool = VTCompressionSessionGetPixelBufferPool(vt),
+           let attrs = CVPixelBufferPoolGetPixelBufferAttributes(pool) as? [String: Any] {
+            let v = attrs[kCVPixelBufferPixelFormatTypeKey as String]
+            if let f = v as? OSType {
+                format = f
+            } else if let list = v as? [OSType], !list.contains(want), let f = list.first {
+                format = f // le format capture n'est pas accepté tel quel
+            }
+            if let pw = attrs[kCVPixelBufferWidthKey as String] as? Int { w = pw }
+            if let ph = attrs[kCVPixelBufferHeightKey as String] as? Int { h = ph }
+        }
+        return ((format, w, h), "pool \(FormatSelector.fourCC(format))\(isShared ? " partagé" : "")")
+    }
+
+    /// Buffer capture utilisable tel quel par VT : IOSurface, même format, mêmes dimensions
+    private func isDirectHandOff(_ buf: CVPixelBuffer) -> Bool {
+        guard let want = encoderInput else { return false }
+        return CVPixelBufferGetIOSurface(buf) != nil
+            && CVPixelBufferGetPixelFormatType(buf) == want.format
+            && CVPixelBufferGetWidth(buf) == want.width
+            && CVPixelBufferGetHeight(buf) == want.height
+    }
+
+    /// Vide puis invalide la session VT : plus aucun callback de sortie ensuite (sessionQ)
+    private func teardownEncoder() {
+        guard let vt = vtSession else { return }
+        vtSession = nil
+        encoderInput = nil
+        activeShape = nil
+        VTCompressionSessionCompleteFrames(vt, untilPresentationTimeStamp: .invalid)
+        VTCompressionSessionInvalidate(vt)
+    }
+
+    private func applyGOP(_ vt: VTCompressionSession, _ s: EncoderSettings) {
+        VTSessionSetProperty(vt, key: kVTCompressionPropertyKey_MaxKeyFrameInterval,
+                             value: NSNumber(value: s.gopMode.maxKeyFrameInterval))
+        let safety = s.gopMode == .refresh ? s.refreshInterval : 0 // 0 = sans limite
+        VTSessionSetProperty(vt, key: kVTCompressionPropertyKey_MaxKeyFrameIntervalDuration,
+                             value: NSNumber(value: safety))
+    }
+
+    private func applyBitrate(_ vt: VTCompressionSession, _ s: EncoderSettings) {
+        let br = s.bitrate
+        VTSessionSetProperty(vt, key: kVTCompressionPropertyKey_AverageBitRate, value: NSNumber(value: br))
+        var limits: [NSNumber] = [NSNumber(value: br/8), NSNumber(value: 1)]
+        if s.gopMode == .refresh {
+            // Plafond par frame (~2 frames moyennes sur 1/fps) : l'IDR est lissé au lieu de faire un pic
+            let interval = 1 / max(1, s.fps)
+            limits += [NSNumber(value: Int(Double(br) / 8 * interval * 2)), NSNumber(value: interval)]
+        }
+        VTSessionSetProperty(vt, key: kVTCompressionPropertyKey_DataRateLimits, value: limits as CFArray)
+    }
+
+    /// Taille max d'une slice : frame moyenne / slicesPerFrame, ou un paquet RTP
+    /// en UDP pour qu'une slice parte en single NAL (décodable dès son arrivée).
+    private func applySliceLimit(_ vt: VTCompressionSession, _ s: EncoderSettings) {
+        guard s.lowLatency, !s.hevc else { return } // pas de clé équivalente publique en HEVC
+        let avgFrame = Double(s.bitrate) / 8.0 / max(1, s.fps)
+        var sliceBytes = Int(avgFrame) / max(1, s.slicesPerFrame)
+        if s.udp { sliceBytes = min(sliceBytes, s.maxPayload) }
+        VTSessionSetProperty(vt, key: kVTCompressionPropertyKey_MaxH264SliceBytes,
+                             value: NSNumber(value: max(512, sliceBytes)))
+    }
+
     private func statusUpdate(_ s: String) { DispatchQueue.main.async { self.status = s } }
 
-    // MARK: Capture → Encode (back-pressure : on skippe si envoi en cours)
+    /// Profondeur + budget octets de la file : `depth` frames moyennes, x2 de marge
+    /// (sans marge en transport faible latence : ~2 frames en vol au débit courant)
+    private func configureSendQueue() {
+        let avgFrame = Double(activeBitrate) / 8.0 / max(1, targetFPS)
+        let margin = lowLatencyTransport ? 1.0 : 2.0
+        let budget = max(64 * 1024, Int(avgFrame * Double(sendQueueDepth) * margin))
+        clientsLock.lock(); defer { clientsLock.unlock() }
+        sendDepth = sendQueueDepth
+        sendBudget = budget
+        for c in clients { c.queue.configure(depth: sendDepth, byteBudget: sendBudget) }
+    }
+
+    // MARK: Capture → Encode (back-pressure : on skippe si la file d'envoi est pleine)
     func captureOutput(_ output: AVCaptureOutput,
                        didOutput sampleBuffer: CMSampleBuffer,
                        from connection: AVCaptureConnection) {
-        if sendingFrame { return } // ⚠️ évite de remplir la file quand réseau plafonne
+        let pts = CMSampleBufferGetPresentationTimeStamp(sampleBuffer)
+        let frameId = profiler.beginFrame(captureNs: HostClock.nanos(pts))
+        // ⚠️ évite d'encoder quand tous les lecteurs plafonnent (un seul lecteur lent ne bloque pas)
+        let readers = activeClients
+        if !readers.isEmpty && readers.allSatisfy({ $0.queue.isSaturated }) {
+            profiler.dropped(frameId, reason: .busy)
+            return
+        }
 
         guard let vt = vtSession,
-              let imageBuffer = CMSampleBufferGetImageBuffer(sampleBuffer) else { return }
+              let imageBuffer = CMSampleBufferGetImageBuffer(sampleBuffer) else {
+            profiler.dropped(frameId, reason: .encoderError)
+            return
+        }
+        hot.countHandOff(direct: isDirectHandOff(imageBuffer))
 
         var frameProps: CFDictionary?
-        if forceIDRNext {
+        if hot.takeIDRRequest() {
             let dict: [String: Any] = [kVTEncodeFrameOptionKey_ForceKeyFrame as String: true]
             frameProps = dict as CFDictionary
-            forceIDRNext = false
         }
 
-        let pts = CMSampleBufferGetPresentationTimeStamp(sampleBuffer)
         var flags: VTEncodeInfoFlags = []
+        let submitStart = HostClock.now()
         let st = VTCompressionSessionEncodeFrame(vt,
                                                  imageBuffer: imageBuffer,
                                                  presentationTimeStamp: pts,
                                                  duration: .invalid,
                                                  frameProperties: frameProps,
-                                                 sourceFrameRefcon: nil,
+                                                 sourceFrameRefcon: UnsafeMutableRawPointer(bitPattern: UInt(frameId &+ 1)),
                                                  infoFlagsOut: &flags)
+        profiler.submitted(frameId, start: submitStart, end: HostClock.now())
         if st != noErr {
+            profiler.dropped(frameId, reason: .encoderError)
             statusUpdate("Encode err \(st)")
         }
     }
 
-    // MARK: Encoded output → TCP
-    fileprivate func handleEncodedSampleBuffer(_ sbuf: CMSampleBuffer) {
-        guard let conn = connection,
-              let dataBuffer = CMSampleBufferGetDataBuffer(sbuf) else { return }
-
-        if sendingFrame { return }
-        sendingFrame = true
-        let currentGen = sessionGen
+    fileprivate func handleEncodeFailure(frameId: UInt64) {
+        profiler.dropped(frameId, reason: .encoderError)
+    }
 
+    // MARK: Encoded output → réseau
+    fileprivate func handleEncodedSampleBuffer(_ sbuf: CMSampleBuffer, frameId: UInt64) {
+        let encodeDone = HostClock.now()
+        hot.endReconfigure(at: encodeDone) // première frame de la nouvelle session VT
+        guard let dataBuffer = CMSampleBufferGetDataBuffer(sbuf) else {
+            profiler.dropped(frameId, reason: .encoderError)
+            return
+        }
         // keyframe ?
         var isKey = true
         if let arr = CMSampleBufferGetSampleAttachmentsArray(sbuf, createIfNecessary: false) as? [Any],
@@ -475,33 +1225,155 @@ final class Streamer: NSObject, ObservableObject, AVCaptureVideoDataOutputSample
             isKey = !notSync
         }
 
-        var payload = Data()
-        if let fmt = CMSampleBufferGetFormatDescription(sbuf) {
-            switch outputProtocol {
-            case .annexb:
-                if let spspps = H264Packer.annexBParameterSets(from: fmt) {
-                    if isKey { payload.append(spspps) }      // toujours SPS/PPS sur IDR
-                    else if !sentCodecHeader { payload.append(spspps); sentCodecHeader = true }
-                }
-                if let nals = H264Packer.annexBFromSampleBuffer(dataBuffer: dataBuffer) { payload.append(nals) }
-            case .avcc:
-                if let spspps = H264Packer.avccParameterSets(from: fmt) {
-                    if isKey { payload.append(spspps) }
-                    else if !sentCodecHeader { payload.append(spspps); sentCodecHeader = true }
-                }
-                if let raw = H264Packer.rawFromSampleBuffer(dataBuffer: dataBuffer) { payload.append(raw) }
+        // Codec de la frame elle-même : `codec` peut déjà désigner la session suivante
+        let fmt = CMSampleBufferGetFormatDescription(sbuf)
+        let hevc = fmt.map(NALPacker.isHEVC) ?? false
+        if let fmt = fmt, paramSets.update(with: fmt) { sentCodecHeader = false } // nouveau SPS/PPS → renvoi
+        let withHeader = isKey || !sentCodecHeader // toujours SPS/PPS sur IDR
+        let out = output
+
+        // Enregistrement : même sortie VT, indépendant des lecteurs (tampon borné, jamais bloquant)
+        if recorder.isRecording, let body = NALPacker.annexBFromSampleBuffer(dataBuffer: dataBuffer) {
+            recorder.append(hevc: hevc, isKey: isKey,
+                            config: isKey ? paramSets.framed(for: .annexb) : nil, body: body,
+                            ptsNs: HostClock.nanos(CMSampleBufferGetPresentationTimeStamp(sbuf)))
+        }
+
+        let readers = activeClients
+        guard !readers.isEmpty else {
+            profiler.dropped(frameId, reason: .noClient)
+            return
+        }
+
+        let currentGen = hot.generation
+
+        let bitstream = CMBlockBufferGetDataLength(dataBuffer)
+        profiler.encoded(frameId, at: encodeDone, bytes: bitstream, isKey: isKey)
+        // Admission avant paquetisation : si aucun lecteur ne peut la prendre, la frame
+        // ne consomme ni séquence RTP ni numéro de frame
+        if !isKey && !readers.contains(where: { !$0.queue.isSaturated }) {
+            // Chaque file applique sa politique de drop (IDR seulement à la première P perdue)
+            for c in readers where c.queue.admit(bytes: bitstream, isKey: false) == .dropNeedsIDR {
+                hot.requestIDR()
             }
+            profiler.dropped(frameId, reason: .late)
+            return
         }
 
-        if !payload.isEmpty {
-            bytesWindow += payload.count
-            framesWindow += 1
-            conn.send(content: payload, completion: .contentProcessed { [weak self] _ in
-                guard let self = self else { return }
-                if self.sessionGen == currentGen { self.sendingFrame = false }
-            })
-        } else {
-            sendingFrame = false
+        let seq = hot.takeFrameSeq()
+        let pts = CMSampleBufferGetPresentationTimeStamp(sbuf)
+
+        // SEI de latence (avant la première slice de l'access unit)
+        var sei: Data?
+        if out.latencyTags {
+            // Lecteurs susceptibles de prendre la frame : l'écho d'un lecteur saturé attend
+            let tag = latency.take(readers: readers.map { $0.id },
+                                   candidates: readers.filter { !$0.queue.isSaturated }.map { $0.id })
+            sei = LatencySEI.make(hevc: hevc, seq: seq, captureNs: HostClock.nanos(pts),
+                                  encodeDoneNs: encodeDone, tag: tag)
+        }
+
+        // Payload en régions non contiguës : SPS/PPS + préfixes en petits buffers,
+        // le bitstream reste dans le CMBlockBuffer (aucune copie côté app)
+        var packets: [DispatchData] = []
+        switch out.proto {
+        case .annexb, .avcc, .framed:
+            let annexB = out.proto != .avcc
+            var payload = DispatchData.empty
+            var flags: FrameHeader.Flags = isKey ? [.keyframe] : []
+            if withHeader, let spspps = paramSets.framed(for: out.proto) {
+                payload.append(spspps)
+                flags.insert(.config)
+            }
+            if let sei = sei {
+                payload.append(annexB ? NALPacker.annexBNALs([sei]) : NALPacker.avccNALs([sei]))
+                flags.insert(.latency)
+            }
+            let body = annexB
+                ? NALPacker.annexBFromSampleBuffer(dataBuffer: dataBuffer)
+                : NALPacker.rawFromSampleBuffer(dataBuffer: dataBuffer)
+            if let body = body { payload.append(body) }
+            if out.proto == .framed && !payload.isEmpty {
+                var framed = FrameHeader.make(hevc: hevc, flags: flags, seq: seq,
+                                              ptsNs: HostClock.nanos(pts), length: payload.count)
+                framed.append(payload)
+                payload = framed
+            }
+            if !payload.isEmpty { packets = [payload] }
+        case .rtp:
+            var prefix = withHeader ? (paramSets.sets ?? []) : []
+            if let sei = sei { prefix.append(sei) }
+            let firstSeq = rtpPacketizer.nextSequenceNumber
+            packets = rtpPacketizer.packetize(dataBuffer: dataBuffer, prefixNALs: prefix, pts: pts)
+            if out.nackDeadlineMs > 0 {
+                let deadline = HostClock.now() + UInt64(out.nackDeadlineMs * 1_000_000)
+                rtxHistory.store(packets, firstSeq: firstSeq, deadline: deadline)
+            }
+            packets = rtpFEC.protect(packets, firstSeq: firstSeq,
+                                     timestamp: RTPPacketizer.timestamp(for: pts), groupSize: out.fecGroupSize)
+        }
+        guard !packets.isEmpty else {
+            profiler.dropped(frameId, reason: .encoderError)
+            return
+        }
+        if withHeader { sentCodecHeader = true }
+
+        // Encodée et paquetisée une fois, puis proposée à chaque lecteur (file propre à chacun)
+        let frame = EncodedFrame(frameId: frameId, seq: seq, isKey: isKey, bitstream: bitstream, packets: packets)
+        hot.countFrame(bytes: frame.size)
+        let abr = out.adaptive
+        if fanOut.distribute(frame, to: readers, send: { self.send($1, to: $0, gen: currentGen, abr: abr) }) {
+            hot.requestIDR()
+        }
+        if fanOut.wasDropped(frame) { profiler.dropped(frameId, reason: .late) }
+    }
+
+    /// Un message (datagramme en UDP) par paquet, envoyé région par région sans aplatir
+    /// le DispatchData : seule la dernière région le clôt et porte la complétion
+    private static func send(_ d: DispatchData, on conn: NWConnection, context: NWConnection.ContentContext,
+                             completion: NWConnection.SendCompletion) {
+        let parts = NALPacker.contiguousRegions(d)
+        guard !parts.isEmpty else {
+            conn.send(content: nil, contentContext: context, isComplete: true, completion: completion)
+            return
+        }
+        for (i, part) in parts.enumerated() {
+            let last = i == parts.count - 1
+            conn.send(content: part, contentContext: context, isComplete: last,
+                      completion: last ? completion : .idempotent)
+        }
+    }
+
+    /// Un datagramme par paquet RTP ; l'ordre est préservé, le dernier libère la frame
+    private func send(_ frame: EncodedFrame, to client: StreamClient, gen: UInt64, abr: Bool) {
+        let conn = client.connection
+        let ctx = client.context
+        let clientId = client.id
+        let sentAt = HostClock.now()
+        conn.batch {
+            for (i, p) in frame.packets.enumerated() {
+                guard i == frame.packets.count - 1 else {
+                    Self.send(p, on: conn, context: ctx, completion: .idempotent)
+                    continue
+                }
+                Self.send(p, on: conn, context: ctx,
+                          completion: .contentProcessed { [weak self, weak client] _ in
+                    guard let self = self else { return }
+                    // Compté même si le lecteur est parti : sinon la frame n'est jamais close
+                    let last = self.fanOut.completed(frame)
+                    guard self.hot.generation == gen else { return } // session précédente
+                    let done = HostClock.now()
+                    // Profiler : fin d'envoi = dernier lecteur servi
+                    if last { self.profiler.sent(frame.frameId, at: done) }
+                    self.latency.sendCompleted(client: clientId, seq: frame.seq, at: done)
+                    guard let client = client else { return }
+                    client.queue.complete(bytes: frame.bitstream)
+                    // ABR (TCP) : la latence de chaque lecteur compte, le plus lent tire le débit vers le bas
+                    if abr {
+                        self.rateController.record(sendLatency: Double(done - sentAt) / 1_000_000_000)
+                    }
+                })
+            }
         }
     }
 
@@ -511,11 +1383,49 @@ final class Streamer: NSObject, ObservableObject, AVCaptureVideoDataOutputSample
         t.schedule(deadline: .now() + 1, repeating: 1)
         t.setEventHandler { [weak self] in
             guard let self = self else { return }
-            let fps = self.framesWindow
-            let mbps = Double(self.bytesWindow) * 8.0 / 1_000_000.0
-            self.metrics = String(format: "~%2d fps • ~%.1f Mb/s", fps, mbps)
-            self.framesWindow = 0
-            self.bytesWindow = 0
+            let window = self.hot.takeWindow()
+            let fps = window.frames
+            let mbps = Double(window.bytes) * 8.0 / 1_000_000.0
+            let expired = self.expireSilentClients()
+            if !expired.isEmpty {
+                self.status = "UDP client " + expired.map { "#\($0.id)" }.joined(separator: ", ") + " expiré (silencieux)"
+            }
+            let readers = self.activeClients
+            let drops = readers.reduce(0) { $0 + $1.queue.takeDropped() }
+            var line = String(format: "~%2d fps • ~%.1f Mb/s • drop %d • %d lecteur(s)", fps, mbps, drops, readers.count)
+            if self.adaptiveActive {
+                if self.rateController.evaluate(drops: drops, frameInterval: 1 / max(1, self.targetFPS)) != nil {
+                    self.applyRateChange()
+                }
+                line += String(format: " • ABR %d Mb/s", self.rateController.current / 1_000_000)
+            }
+            // Hand-off capture → VT : toute frame non conforme implique une conversion dans VT
+            let handOff = self.hot.takeHandOff()
+            if handOff.converted > 0 {
+                line += " • conv \(handOff.converted)/\(handOff.direct + handOff.converted)"
+            } else if handOff.direct > 0 {
+                line += " • zero-copy"
+            }
+            if let ms = self.hot.lastReconfigureMs { line += String(format: " • reconf %.0f ms", ms) }
+            if !self.thermalGovernor {
+                self.governor.reset()
+            } else {
+                let thermal = ProcessInfo.processInfo.thermalState
+                if let level = self.governor.evaluate(thermal: thermal,
+                                                      encodeP95: self.profiler.encodeTime(percentile: 0.95),
+                                                      frameInterval: 1 / max(1, self.targetFPS)) {
+                    self.applyGovernorLevel(level)
+                }
+                if self.governor.level > 0 { line += " • 🌡 " + QualityGovernor.label(self.governor.level) }
+            }
+            if self.isRecording {
+                let rec = self.recorder.counters
+                if !self.recorder.isRecording { self.isRecording = false } // erreur d'écriture
+                line += " • rec \(rec.written)" + (rec.dropped > 0 ? " (drop \(rec.dropped))" : "")
+            }
+            if let rx = self.receiverLatency { line += " • " + rx }
+            self.metrics = line
+            self.profiling = self.profiler.summary()
         }
         t.resume()
         self.statsTimer = t
@@ -523,7 +1433,7 @@ final class Streamer: NSObject, ObservableObject, AVCaptureVideoDataOutputSample
 
     private func stopStats() {
         statsTimer?.cancel(); statsTimer = nil
-        framesWindow = 0; bytesWindow = 0
+        _ = hot.takeWindow()
     }
 
     // MARK: Auto-rotate (notif + poller, marche même avec verrou d’orientation)
@@ -584,6 +1494,8 @@ final class Streamer: NSObject, ObservableObject, AVCaptureVideoDataOutputSample
         case .portrait:           newOri = .portrait
         default:                  newOri = conn.videoOrientation // ne change rien si « unknown »
         }
-        if conn.videoOrientation != newOri { conn.videoOrientation = newOri }
+        guard conn.videoOrientation != newOri else { return }
+        conn.videoOrientation = newOri
+        sessionQ.async { self.followOrientation() }
     }
 }
@@ -0,0 +1,53 @@
+import Foundation
+import Network
+
+/// Paramètres réseau du listener. Profil faible latence :
+///   TCP  — noDelay (pas de Nagle), ACK non étirés, classe de service interactiveVideo
+///   UDP  — interactiveVideo, sans marquage ECN : ECT(1) promet une réponse aux CE (RFC 3168 /
+///          9331) alors que le lecteur ne renvoie aucun compte CE et que l'ABR est coupé en UDP
+/// Network.framework n'expose pas SO_SNDBUF : le tampon d'envoi est borné côté app
+/// par la SendQueue (≈ 2 frames au débit courant dans ce profil).
+enum TransportProfile {
+    static func parameters(udp: Bool, lowLatency: Bool, link: LinkMode) -> NWParameters {
+        let params: NWParameters
+        if udp {
+            params = .udp
+        } else if lowLatency {
+            let tcp = NWProtocolTCP.Options()
+            tcp.noDelay = true
+            tcp.disableAckStretching = true
+            params = NWParameters(tls: nil, tcp: tcp)
+        } else {
+            params = .tcp
+        }
+        params.allowLocalEndpointReuse = true
+        if lowLatency { params.serviceClass = .interactiveVideo }
+        if link == .wired {
+            // Pas de requiredInterfaceType = .wiredEthernet : le tunnel usbmuxd arrive en loopback
+            params.prohibitedInterfaceTypes = [.wifi, .cellular]
+        }
+        return params
+    }
+
+    /// Contexte d'envoi UDP : classe de service des datagrammes RTP (ECN non marqué, cf. plus haut)
+    static func datagramContext(lowLatency: Bool) -> NWConnection.ContentContext {
+        guard lowLatency else { return .defaultMessage }
+        let ip = NWProtocolIP.Metadata()
+        ip.serviceClass = .interactiveVideo
+        return NWConnection.ContentContext(identifier: "rtp", metadata: [ip])
+    }
+
+    /// Options d'une connexion prête (pour le statut) : tampon effectif, classe de service demandée
+    static func describe(_ conn: NWConnection, udp: Bool, lowLatency: Bool) -> String {
+        var parts: [String] = []
+        if let tcp = conn.metadata(definition: NWProtocolTCP.definition) as? NWProtocolTCP.Metadata {
+            parts.append("sndbuf \(tcp.availableSendBuffer / 1024) Ko")
+        }
+        if lowLatency {
+            parts.append(udp ? "ECN off (pas de retour CE)" : "nodelay")
+            // Valeur demandée dans les paramètres : Network.framework n'expose pas la classe négociée
+            parts.append(conn.parameters.serviceClass == .interactiveVideo ? "interactiveVideo demandé" : "best-effort")
+        }
+        return parts.isEmpty ? "" : " [" + parts.joined(separator: ", ") + "]"
+    }
+}
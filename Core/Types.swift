@@ -8,7 +8,45 @@ enum Resolution: CaseIterable {
     var label: String { switch self { case .r720p: "720p"; case .r1080p: "1080p"; case .r4k: "4K" } }
 }
 
-enum OutputProtocol { case annexb, avcc }
+enum OutputProtocol {
+    case annexb, avcc, framed, rtp
+    var usesUDP: Bool { self == .rtp }
+}
+
+/// Lien réseau accepté par le listener. `.wired` : Wi-Fi et cellulaire interdits ;
+/// restent le loopback (tunnel usbmuxd / iproxy, TCP seulement) et l'Ethernet filaire
+/// (adaptateur USB-Ethernet, partage de connexion USB).
+enum LinkMode: CaseIterable {
+    case any, wired
+    var label: String { self == .any ? "Tous" : "Filaire / USB" }
+}
+
+/// Structure de GOP. `.refresh` : GOP infini à taille de frame plafonnée (≈ 2 frames
+/// moyennes) ; pas d'intra-refresh public dans VT, la resynchro se fait par IDR à la
+/// demande du lecteur, plus un IDR de sécurité toutes les `refreshInterval` s.
+enum GOPMode: CaseIterable {
+    case allIntra, gop30, refresh
+    var label: String {
+        switch self { case .allIntra: return "All-I"; case .gop30: return "GOP 30"; case .refresh: return "Long GOP" }
+    }
+    var maxKeyFrameInterval: Int32 {
+        switch self { case .allIntra: return 1; case .gop30: return 30; case .refresh: return 0 } // 0 = sans limite
+    }
+}
+
+enum VideoCodec: CaseIterable {
+    case h264, hevc, hevc10
+    var label: String {
+        switch self { case .h264: return "H.264"; case .hevc: return "HEVC"; case .hevc10: return "HEVC 10-bit" }
+    }
+    var isHEVC: Bool { self != .h264 }
+    var codecType: CMVideoCodecType { isHEVC ? kCMVideoCodecType_HEVC : kCMVideoCodecType_H264 }
+    // 10-bit : capture x420 (vidéo range) pour éviter une conversion avant l'encodeur
+    var pixelFormat: OSType {
+        self == .hevc10 ? kCVPixelFormatType_420YpCbCr10BiPlanarVideoRange
+                        : kCVPixelFormatType_420YpCbCr8BiPlanarFullRange
+    }
+}
 
 enum H264Profile: CaseIterable {
     case baseline, main, high
@@ -26,13 +64,28 @@ struct PendingConfig {
     var port: UInt16 = 5000
     var resolution: Resolution = .r1080p
     var fps: Double = 120
-    var bitrate: Double = 60_000_000
-    var intraOnly: Bool = true
+    var bitrate: Double = 60_000_000        // plafond si débit adaptatif
+    var adaptiveBitrate: Bool = false
+    var minBitrate: Double = 10_000_000
+    var gopMode: GOPMode = .allIntra
+    var refreshInterval: Double = 2  // Long GOP : IDR de sécurité (s, 0 = jamais)
+    var codec: VideoCodec = .h264
     var outputProtocol: OutputProtocol = .annexb
+    var link: LinkMode = .any
+    var lowLatencyTransport: Bool = false // nodelay, interactiveVideo, file d'envoi serrée
     var orientation: AVCaptureVideoOrientation = .portrait
     var autoRotate: Bool = false
     var profile: H264Profile = .baseline
     var entropy: H264Entropy = .cavlc
+    var sendQueueDepth: Int = 2      // frames en vol max (1…4)
+    var fecGroupSize: Int = 0        // RTP : 1 parité XOR tous les N paquets (0 = off)
+    var nackDeadlineMs: Double = 16  // RTP : retransmission tant que la frame a moins de N ms
+    var lowLatency: Bool = false     // RC faible latence + slices
+    var slicesPerFrame: Int = 4
+    var latencyTags: Bool = false    // SEI d'horodatage (mesure glass-to-glass)
+    var prewarmEncoder: Bool = false // 2e session VT prête pour le mode précédent (720p ↔ 4K)
+    var thermalGovernor: Bool = false // baisse fps/débit/résolution avant le bridage thermique iOS
+    var startOnConnect: Bool = false  // un lecteur (Bonjour) qui se connecte lance caméra + encodeur
 
     init() {}
 
@@ -42,11 +95,26 @@ struct PendingConfig {
         resolution = candidates.first { $0.width == s.targetWidth && $0.height == s.targetHeight } ?? .r1080p
         fps = s.targetFPS
         bitrate = Double(s.bitrate)
-        intraOnly = s.intraOnly
+        adaptiveBitrate = s.adaptiveBitrate
+        minBitrate = Double(s.minBitrate)
+        gopMode = s.gopMode
+        refreshInterval = s.refreshInterval
+        codec = s.codec
         outputProtocol = s.outputProtocol
+        link = s.link
+        lowLatencyTransport = s.lowLatencyTransport
         orientation = s.orientation
         autoRotate = s.autoRotate
         profile = s.profile
         entropy = s.entropy
+        sendQueueDepth = s.sendQueueDepth
+        fecGroupSize = s.fecGroupSize
+        nackDeadlineMs = s.nackDeadlineMs
+        lowLatency = s.lowLatency
+        slicesPerFrame = s.slicesPerFrame
+        latencyTags = s.latencyTags
+        prewarmEncoder = s.prewarmEncoder
+        thermalGovernor = s.thermalGovernor
+        startOnConnect = s.startOnConnect
     }
 }
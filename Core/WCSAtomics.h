@@ -0,0 +1,43 @@
+#ifndef WCSAtomics_h
+#define WCSAtomics_h
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+// Atomiques minimales pour les structures lock-free du hot path (Swift n'a pas
+// d'atomiques natives en iOS 15). La mémoire est allouée côté Swift (adresse
+// stable, UnsafeMutablePointer<UInt64>) et vue ici comme _Atomic uint64_t.
+
+static inline uint64_t wcs_load_acquire(const uint64_t *p) {
+    return atomic_load_explicit((const _Atomic uint64_t *)p, memory_order_acquire);
+}
+
+static inline uint64_t wcs_load_relaxed(const uint64_t *p) {
+    return atomic_load_explicit((const _Atomic uint64_t *)p, memory_order_relaxed);
+}
+
+static inline void wcs_store_release(uint64_t *p, uint64_t v) {
+    atomic_store_explicit((_Atomic uint64_t *)p, v, memory_order_release);
+}
+
+static inline void wcs_store_relaxed(uint64_t *p, uint64_t v) {
+    atomic_store_explicit((_Atomic uint64_t *)p, v, memory_order_relaxed);
+}
+
+static inline uint64_t wcs_fetch_add(uint64_t *p, uint64_t v) {
+    return atomic_fetch_add_explicit((_Atomic uint64_t *)p, v, memory_order_relaxed);
+}
+
+static inline uint64_t wcs_exchange(uint64_t *p, uint64_t v) {
+    return atomic_exchange_explicit((_Atomic uint64_t *)p, v, memory_order_acq_rel);
+}
+
+static inline void wcs_fence_acquire(void) {
+    atomic_thread_fence(memory_order_acquire);
+}
+
+static inline void wcs_fence_release(void) {
+    atomic_thread_fence(memory_order_release);
+}
+
+#endif /* WCSAtomics_h */
@@ -0,0 +1,216 @@
+#!/usr/bin/env swift
+// Rejoue une capture `.wcsf` (in-app recorder, format de Core/FramedProtocol.swift) sur TCP,
+// comme l'iPhone le ferait : au rythme enregistré (écarts de PTS) ou à vitesse max.
+// Aucune dépendance au code du lecteur : seul le format du fichier est utilisé.
+//
+//   swift Tools/wcsf-replay.swift capture.wcsf [--port 5000] [--proto framed|annexb]
+//                                              [--max-speed] [--loop]
+//
+// Chaque lecteur connecté reçoit le fichier depuis le début (il commence sur un IDR).
+// `framed` envoie les enregistrements tels quels, `annexb` seulement les access units.
+// L'envoi suivant attend la fin du précédent : un lecteur lent prend du retard (compté),
+// rien n'est jeté. En boucle, seq et PTS continuent au lieu de repartir de zéro.
+import Foundation
+import Network
+
+// MARK: Fichier
+
+struct Record {
+    let start: Int     // début de l'en-tête dans le fichier
+    let headerSize: Int
+    let length: Int    // payload
+    let seq: UInt32
+    let ptsNs: UInt64
+    let hevc: Bool
+}
+
+func be(_ b: [UInt8], _ o: Int, _ n: Int) -> UInt64 {
+    (0..<n).reduce(UInt64(0)) { $0 << 8 | UInt64(b[o + $1]) }
+}
+
+func parse(_ b: [UInt8]) -> [Record] {
+    let magic: [UInt8] = [0x57, 0x43, 0x53, 0x46] // "WCSF"
+    var out: [Record] = []
+    var off = 0
+    while off + 24 <= b.count {
+        guard Array(b[off..<off + 4]) == magic else {
+            FileHandle.standardError.write("En-tête invalide à l'octet \(off), fin de lecture\n".data(using: .utf8)!)
+            break
+        }
+        let hdr = Int(b[off + 7])
+        let len = Int(be(b, off + 20, 4))
+        guard hdr >= 24, off + hdr + len <= b.count else { break } // dernier enregistrement tronqué
+        let flags = b[off + 6]
+        if flags & 0x08 == 0 { // préludes hors séquence : pas des frames du flux
+            out.append(Record(start: off, headerSize: hdr, length: len, seq: UInt32(be(b, off + 8, 4)),
+                              ptsNs: be(b, off + 12, 8), hevc: b[off + 5] == 1))
+        }
+        off += hdr + len
+    }
+    return out
+}
+
+// MARK: Options
+
+var input: String?
+var port: UInt16 = 5000
+var annexB = false
+var maxSpeed = false
+var loop = false
+var args = CommandLine.arguments.dropFirst().makeIterator()
+while let a = args.next() {
+    switch a {
+    case "--port":      port = args.next().flatMap(UInt16.init) ?? port
+    case "--proto":     annexB = args.next() == "annexb"
+    case "--max-speed": maxSpeed = true
+    case "--loop":      loop = true
+    default:            input = a
+    }
+}
+guard let path = input, let file = FileManager.default.contents(atPath: path) else {
+    print("usage: wcsf-replay.swift <capture.wcsf> [--port 5000] [--proto framed|annexb] [--max-speed] [--loop]")
+    exit(2)
+}
+let bytes = [UInt8](file)
+let records = parse(bytes)
+guard let first = records.first, let last = records.last else {
+    print("Aucune frame dans \(path)")
+    exit(1)
+}
+let firstPts = first.ptsNs
+let span = last.ptsNs >= firstPts ? last.ptsNs - firstPts : 0
+// Durée d'une frame (pour enchaîner les boucles) : écart moyen entre PTS
+let frameNs = records.count > 1 ? span / UInt64(records.count - 1) : 8_333_333
+
+func now() -> UInt64 { DispatchTime.now().uptimeNanoseconds }
+
+func put(_ v: UInt64, _ n: Int, into d: inout Data, at o: Int) {
+    for i in 0..<n { d[o + i] = UInt8(truncatingIfNeeded: v >> UInt64(8 * (n - 1 - i))) }
+}
+
+// MARK: Envoi
+
+final class Replay {
+    let id: Int
+    let conn: NWConnection
+    let q: DispatchQueue
+    var index = 0
+    var lap: UInt64 = 0        // tours déjà joués (--loop)
+    var startNs: UInt64 = 0
+    var sent = 0
+    var sentBytes = 0
+    var late = 0               // frames parties plus d'une frame après leur échéance
+    var done = false
+
+    init(id: Int, conn: NWConnection) {
+        self.id = id
+        self.conn = conn
+        self.q = DispatchQueue(label: "replay.\(id)")
+    }
+
+    func start() {
+        conn.stateUpdateHandler = { [self] st in
+            switch st {
+            case .ready:
+                print("#\(id) connecté : \(conn.endpoint)")
+                startNs = now()
+                next()
+            case .failed(let e):
+                finish("erreur \(e)")
+            case .cancelled:
+                finish("fermé")
+            default: break
+            }
+        }
+        conn.start(queue: q)
+    }
+
+    /// Enregistrement `r` prêt à partir : en-tête recalé sur le tour courant (seq, PTS)
+    private func content(_ r: Record) -> Data {
+        let body = r.start + r.headerSize
+        if annexB { return file.subdata(in: body..<body + r.length) }
+        var d = file.subdata(in: r.start..<body + r.length)
+        if lap > 0 {
+            let n = UInt64(records.count)
+            put(UInt64(r.seq) &+ lap * n, 4, into: &d, at: 8)
+            put(r.ptsNs &+ lap * (span + frameNs), 8, into: &d, at: 12)
+        }
+        return d
+    }
+
+    private func next() {
+        guard !done else { return }
+        if index == records.count {
+            guard loop else {
+                conn.send(content: nil, contentContext: .finalMessage, isComplete: true,
+                          completion: .contentProcessed { [self] _ in conn.cancel() })
+                return
+            }
+            index = 0
+            lap += 1
+        }
+        let r = records[index]
+        if !maxSpeed {
+            let offset = (r.ptsNs >= firstPts ? r.ptsNs - firstPts : 0) + lap * (span + frameNs)
+            let due = startNs + offset
+            let t = now()
+            if due > t {
+                q.asyncAfter(deadline: DispatchTime(uptimeNanoseconds: due)) { [self] in next() }
+                return
+            }
+            if t - due > frameNs { late += 1 }
+        }
+        index += 1
+        let d = content(r)
+        conn.send(content: d, completion: .contentProcessed { [self] error in
+            if let e = error { finish("erreur d'envoi \(e)"); return }
+            sent += 1
+            sentBytes += d.count
+            next()
+        })
+    }
+
+    private func finish(_ why: String) {
+        guard !done else { return }
+        done = true
+        let s = Double(now() - startNs) / 1e9
+        let mbps = s > 0 ? Double(sentBytes) * 8 / s / 1e6 : 0
+        print(String(format: "#%d %@ : %d frames, %.1f Mo en %.2f s (%.1f Mb/s), %d en retard",
+                     id, why, sent, Double(sentBytes) / 1e6, s, mbps, late))
+        let id = self.id
+        DispatchQueue.main.async { replays[id] = nil }
+    }
+}
+
+// MARK: Listener
+
+var replays: [Int: Replay] = [:] // queue principale
+var nextId = 0
+
+let codec = first.hevc ? "HEVC" : "H.264"
+print(String(format: "%@ : %d frames %@, %.2f s, ~%.0f fps ; %@, %@, port %d%@",
+             (path as NSString).lastPathComponent, records.count, codec, Double(span) / 1e9,
+             frameNs > 0 ? 1e9 / Double(frameNs) : 0, annexB ? "annexb" : "framed",
+             maxSpeed ? "vitesse max" : "rythme enregistré", Int(port), loop ? ", en boucle" : ""))
+
+let params = NWParameters.tcp
+params.allowLocalEndpointReuse = true
+(params.defaultProtocolStack.transportProtocol as? NWProtocolTCP.Options)?.noDelay = true
+guard let listener = try? NWListener(using: params, on: NWEndpoint.Port(rawValue: port)!) else {
+    print("Port \(port) indisponible")
+    exit(1)
+}
+listener.newConnectionHandler = { conn in
+    nextId += 1
+    let r = Replay(id: nextId, conn: conn)
+    replays[nextId] = r
+    r.start()
+}
+listener.stateUpdateHandler = { st in
+    if case .failed(let e) = st {
+        print("Listener : \(e)")
+        exit(1)
+    }
+}
+listener.start(queue: .main)
+dispatchMain()